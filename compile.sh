@@ -1,9 +1,72 @@
 #!/bin/sh
 rm -f tictactoe.exe 2>/dev/null
 
-gcc -Iheader `pkg-config --cflags --static gtk+-3.0` -o tictactoe \
-    src/main.c src/minimax.c src/importData.c src/ml-naive-bayes.c src/elapsedTime.c \
-    `pkg-config --libs --static gtk+-3.0` \
+ENGINE_SRC="src/minimax.c src/bitboard.c src/nkBoard.c src/transposition.c src/threadPool.c src/mcts.c src/bestMoveStore.c src/gameDb.c src/gameState.c src/profiler.c src/searchStats.c src/logger.c"
+
+# Solve every position once and emit the perfect-play move tables
+gcc -O2 -pthread -Iheader -o genMoveTable tools/genMoveTable.c $ENGINE_SRC -lm && \
+    ./genMoveTable src/moveTable.c > /dev/null
+
+if [ $? -ne 0 ]; then
+	echo "[COMPILE] FAILED TO GENERATE MOVE TABLE!!!"
+	exit 1
+fi
+
+# libtictactoe: the engines behind the Engine/Game API of header/tictactoe.h, as a static
+# and a shared library. The GUI and the tools are clients of it.
+LIB_SRC="src/tictactoe.c src/importData.c src/ml-naive-bayes.c src/moveTable.c $ENGINE_SRC"
+mkdir -p obj
+for src in $LIB_SRC; do
+	gcc -O2 -pthread -fPIC -Iheader -c $src -o obj/$(basename $src .c).o || exit 1
+done
+rm -f libtictactoe.a
+ar rcs libtictactoe.a obj/*.o && \
+    gcc -shared -pthread -o libtictactoe.so obj/*.o -lm
+
+if [ $? -ne 0 ]; then
+	echo "[COMPILE] FAILED TO BUILD LIBTICTACTOE!!!"
+	exit 1
+fi
+
+# Converter from the old resources/bestmove.txt to the binary lookup file
+gcc -O2 -pthread -Iheader -o convertBestMove tools/convertBestMove.c src/bestMoveStore.c src/bitboard.c src/logger.c
+
+# Search benchmarks: serial vs parallel alpha-beta, MCTS playouts/sec
+gcc -O2 -pthread -Iheader -o benchParallel tools/benchParallel.c libtictactoe.a -lm
+gcc -O2 -pthread -Iheader -o benchMcts tools/benchMcts.c libtictactoe.a -lm
+
+# Self-play tournament of the 3x3 engines: results, Elo and games/sec
+gcc -O2 -pthread -Iheader -o tournament tools/tournament.c libtictactoe.a -lm
+
+# UCI-style engine on stdin/stdout for scripted and batch play
+gcc -O2 -pthread -Iheader -o tictactoeUci tools/tictactoeUci.c libtictactoe.a -lm
+
+# Perft node counter, with the ASM helpers and with their pure C versions
+gcc -O2 -pthread -Iheader -o perft tools/perft.c libtictactoe.a -lm
+gcc -O2 -pthread -Iheader -DDISABLE_ASM=1 -o perftC tools/perft.c src/moveTable.c $ENGINE_SRC -lm
+
+# Searches at two depth limits back to back must not reuse each other's table entries
+gcc -O2 -pthread -Iheader -o checkDepthLimits tools/checkDepthLimits.c libtictactoe.a -lm && \
+    ./checkDepthLimits > /dev/null
+
+if [ $? -ne 0 ]; then
+	echo "[COMPILE] DEPTH LIMITS SHARE TRANSPOSITION ENTRIES!!!"
+	exit 1
+fi
+
+# Multi-game server over epoll and its load generator, Linux only
+if [ "$(uname)" = "Linux" ]; then
+	gcc -O2 -pthread -Iheader -o tictactoeServer tools/tictactoeServer.c libtictactoe.a -lm
+	gcc -O2 -pthread -Iheader -o loadGen tools/loadGen.c libtictactoe.a -lm
+fi
+
+# Retrograde solver writing the game-value databases read by findBestMove()
+gcc -O2 -pthread -Iheader -o solveRetrograde tools/solveRetrograde.c src/gameDb.c src/nkBoard.c src/threadPool.c src/logger.c && \
+    ./solveRetrograde 3 3 > /dev/null
+
+gcc -O2 -pthread -Iheader `pkg-config --cflags --static gtk+-3.0` -o tictactoe \
+    src/main.c libtictactoe.a \
+    `pkg-config --libs --static gtk+-3.0` -lm \
 
 	#enable this for windows 11 release only!!! 
 	#Only for project submission backup if user can't compile, run docker, install libs.
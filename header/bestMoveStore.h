@@ -0,0 +1,190 @@
+/**
+ * @file bestMoveStore.h
+ * @author jacktan-jk
+ * @brief Best moves learnt by the Minimax engine, shared by all processes and saved to a binary file.
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2024
+ *
+ * Moves are kept apart by the settings that found them, so a depth-limited move is never
+ * served to perfect play. Each combination of engine version, search mode, depth limit
+ * and board size (`bestMoveKey()`) has its own namespace, up to `BESTMOV_NAMESPACES`.
+ * The file is a fixed-size `BestMoveHeader`, the keys of the namespaces (0 while unused),
+ * then one table per namespace of one byte per base-3 board code (3^9 slots). A slot
+ * holds `cell + 1` for the stored move (`cell = row * 3 + col`) or `MOVETABLE_NONE`.
+ * Because every board has exactly one slot per namespace the file never grows and a
+ * board can never be stored twice.
+ *
+ * The table lives in a POSIX shared memory segment, one per file, that every process
+ * using the file maps: the first one loads the file into it, and a board solved by one
+ * game is a hit for all the others at once. A lookup is a single read from the segment.
+ * A store is one compare-and-swap on the board's slot: the first move stored for a board
+ * wins and the table needs no lock.
+ *
+ * One of the processes, the persister, writes the segment to the file. It renames a
+ * complete new file over the old one, so a crash never leaves a torn file behind. A
+ * snapshot is written `BESTMOV_FLUSH_MS` after the table changed, sooner after
+ * `BESTMOV_FLUSH_BATCH` new moves from any process, and when the last process closes the
+ * table; every process checks the segment each `BESTMOV_POLL_MS` for moves stored by the
+ * others. A process exiting hands the role to the next one; the role of a process that
+ * died is taken over.
+ *
+ * Processes open and close the segment one at a time, holding a lock on the file named
+ * like the best move file plus `BESTMOV_LOCK_SUFFIX`. A crash releases that lock. The
+ * segment records the pid of each process using it. The next process to open it therefore
+ * finds a segment left behind by crashed processes: one never sized or loaded, or one
+ * whose users have all died. It saves that segment's moves, unlinks it and loads the file
+ * into a new one. A closing process drops the users that died, so the last live one
+ * still removes the segment.
+ *
+ * The previous CSV format (`x,o,b,...,row,col` per line) can be converted with
+ * `convertBestMove`, and is imported automatically when the binary file is first created.
+ */
+
+#ifndef BESTMOVESTORE_H
+#define BESTMOVESTORE_H
+
+#include <macros.h>
+#include <logger.h>
+#include <bitboard.h>
+#include <moveTable.h>
+
+#define FILE_BESTMOV "resources/bestmove.bin"      /**< Path to the binary best move file */
+#define FILE_BESTMOV_TXT "resources/bestmove.txt"  /**< Path to the legacy CSV best move file */
+
+#define BESTMOV_MAGIC "TTTMOVES"   /**< File signature, without terminator */
+#define BESTMOV_VERSION 2          /**< Format version written in the header */
+#define BESTMOV_NAMESPACES 8       /**< Engine settings the file keeps moves for */
+
+#define BESTMOV_SHM_PREFIX "/tictactoe-bestmove-v" /**< Name of the shared segments, then version and path hash */
+#define BESTMOV_LOCK_SUFFIX ".lock"  /**< Appended to the file's path to name the lock held while opening or closing */
+#define BESTMOV_MAX_USERS 64         /**< Processes that can have one file open at once */
+#define BESTMOV_FLUSH_BATCH 256      /**< New moves that start a snapshot at once */
+#define BESTMOV_FLUSH_MS 1000        /**< Longest time a new move waits for its snapshot, in ms */
+#define BESTMOV_POLL_MS 50           /**< How often every process checks the segment for new moves, in ms */
+
+/**
+ * @struct BestMoveHeader
+ * @brief Fixed header at the start of the binary best move file.
+ */
+struct BestMoveHeader
+{
+    char magic[8];       /**< `BESTMOV_MAGIC` */
+    uint32_t version;    /**< `BESTMOV_VERSION` */
+    uint32_t slotCount;  /**< Number of move slots per namespace, `BB_CODES` */
+    uint32_t namespaceCount; /**< `BESTMOV_NAMESPACES` */
+    uint32_t reserved;   /**< 0, aligns the namespace keys */
+};
+
+/**
+ * @brief Packs the settings a move was found with into a namespace key.
+ *
+ * @param engineVersion `MINIMAX_ENGINE_VERSION` of the engine.
+ * @param searchMode `SEARCH_MINIMAX` or `SEARCH_ALPHABETA`.
+ * @param depthLimit Deepest ply, or `NO_DEPTH_LIMIT`.
+ * @param n Board side; only 3x3 boards are stored for now.
+ * @param k Number in a row needed to win.
+ * @return The key, never 0.
+ */
+static inline uint64_t bestMoveKey(int engineVersion, int searchMode, int depthLimit, int n, int k)
+{
+    return 1ULL << 63 | (uint64_t)(uint16_t)engineVersion << 32 | (uint64_t)(uint8_t)(depthLimit + 1) << 24 |
+           (uint64_t)(uint8_t)searchMode << 16 | (uint64_t)(uint8_t)n << 8 | (uint8_t)k;
+}
+
+/**
+ * @struct BestMoveShared
+ * @brief Control block at the start of the shared segment, followed by the file's image.
+ */
+struct BestMoveShared
+{
+    uint32_t isReady;          /**< Set once the creator of the segment has loaded the file */
+    int32_t users[BESTMOV_MAX_USERS]; /**< pids of the processes that have the segment open, 0 for a free entry */
+    int32_t persister;         /**< pid of the process writing the snapshots, 0 for none */
+    int32_t storedMoves;       /**< Number of non-empty slots */
+    uint64_t generation;       /**< Moves stored since the segment was created */
+    uint64_t savedGeneration;  /**< `generation` of the last snapshot */
+};
+
+/**
+ * @brief Maps the shared table of the binary best move file, creating them if needed.
+ *
+ * Attaches to the segment of another process using the file, or loads the file into a
+ * new one. A missing, truncated or foreign file starts an empty table; when it
+ * is created and `FILE_BESTMOV_TXT` exists, the old text file is imported into the
+ * namespace of the default settings (`bestMoveDefaultKey()`). The
+ * mapping stays valid until `closeBoardStates()`, which also runs at exit. Calling it
+ * again is a no-op, and concurrent first calls map the file once.
+ *
+ * @return The number of boards stored in the file, or `ERROR` if it cannot be mapped
+ *         (lookups then miss and stores are ignored).
+ *
+ * @see importBestMoveText, closeBoardStates
+ */
+int loadBoardStates();
+
+/**
+ * @brief Maps a binary best move file at a specific path.
+ *
+ * Same as `loadBoardStates()` but without the legacy import; used by `convertBestMove`.
+ * Starts the thread that writes the snapshots while this process is the persister.
+ *
+ * @param path Path of the binary file.
+ * @return The number of boards stored, or `ERROR`, also when `BESTMOV_MAX_USERS` live
+ *         processes have it open already.
+ */
+int openBestMoveFile(const char *path);
+
+/**
+ * @brief Unmaps the shared table, writing a last snapshot if this process is the persister.
+ *
+ * The last process to close the table always saves it and removes the segment, so the
+ * next one loads the file again. Registered with `atexit()` by the first mapping.
+ */
+void closeBoardStates();
+
+/**
+ * @brief Returns the key of the build's default settings, which the legacy text file was written with.
+ */
+uint64_t bestMoveDefaultKey();
+
+/**
+ * @brief Looks the board up in the shared best move table.
+ *
+ * @param key Namespace of the settings searching, see `bestMoveKey()`.
+ * @param board The current Tic Tac Toe board.
+ * @param bestMove Set to the stored move on a hit.
+ * @return `true` if a move is stored for this board.
+ *
+ * @see bbBase3
+ */
+bool checkAndUpdateBestMove(uint64_t key, int board[3][3], struct Position *bestMove);
+
+/**
+ * @brief Stores the best move of a board in the shared table, saved by the next snapshot.
+ *
+ * Lock-free and safe from any thread or process. A board that already has a move keeps it.
+ * The first store of new settings claims a namespace; once all are taken, moves of
+ * further settings are not stored.
+ *
+ * @param key Namespace of the settings that found the move, see `bestMoveKey()`.
+ * @param board The board the move was searched on.
+ * @param bestMove The move, ignored if it is not on the board.
+ */
+void writeBestMoveToFile(uint64_t key, int board[3][3], struct Position bestMove);
+
+/**
+ * @brief Imports a legacy CSV best move file into the shared table.
+ *
+ * Each line is `c0,...,c8,row,col` where a cell is 'x' (BOT), 'o' (PLAYER1) or 'b'.
+ * Incomplete lines (such as the duplicated `row,col` lines older versions wrote) and
+ * out-of-range moves are skipped.
+ *
+ * @param path Path of the CSV file.
+ * @param key Namespace of the settings the file was written with.
+ * @return The number of lines imported, or `BAD_PARAM` if the file cannot be read.
+ */
+int importBestMoveText(const char *path, uint64_t key);
+
+#endif // BESTMOVESTORE_H
@@ -0,0 +1,150 @@
+/**
+ * @file bitboard.h
+ * @author jacktan-jk
+ * @brief Bitboard representation of the Tic-Tac-Toe board used by the Minimax engine.
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2024
+ *
+ * Each side is stored as a 9-bit mask where bit `row * 3 + col` is set when that side
+ * occupies the cell. Wins are detected by testing the mask against a precomputed table
+ * of the 8 winning lines, and empty cells are walked with count-trailing-zeros instead
+ * of scanning the 3x3 array. The helpers are `static inline` so the search kernel in
+ * `minimax.c` and the win check in `main.c` compile down to a handful of instructions.
+ */
+
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include <macros.h>
+#include <stdint.h>
+
+#define BB_CELLS 9        /**< Number of cells on the board */
+#define BB_LINES 8        /**< Number of winning lines (3 rows, 3 columns, 2 diagonals) */
+#define BB_FULL  0x1FF    /**< Mask with all 9 cells set */
+#define BB_CODES 19683    /**< Number of base-3 board codes (3^9) */
+
+#define BB_BIT(row, col) ((uint16_t)(1u << ((row) * 3 + (col))))   /**< Mask of a single cell */
+#define BB_ROW(idx) ((idx) / 3)                                     /**< Row index of a bit index */
+#define BB_COL(idx) ((idx) % 3)                                     /**< Column index of a bit index */
+
+/**
+ * @struct BitBoard
+ * @brief Stores the board as one 9-bit occupancy mask per side.
+ */
+struct BitBoard
+{
+    uint16_t bot;    /**< Cells occupied by the BOT (X) */
+    uint16_t player; /**< Cells occupied by PLAYER1 (O) */
+};
+
+/**
+ * @var bbWinMasks
+ * @brief Precomputed masks of the 8 winning lines (rows, columns then diagonals).
+ *
+ * @var bbWinTable
+ * @brief For every 9-bit occupancy mask, the first line of `bbWinMasks` it completes (0 if none).
+ *
+ * The table is filled from `bbWinMasks` before `main()` runs, turning a win check into
+ * a single 2-byte load.
+ */
+extern const uint16_t bbWinMasks[BB_LINES];
+extern uint16_t bbWinTable[BB_FULL + 1];
+
+/**
+ * @brief Converts a 3x3 array board into its bitboard form.
+ *
+ * @param board A 3x3 array where each cell is `EMPTY`, `PLAYER1` or `BOT`.
+ * @return The equivalent `BitBoard`.
+ */
+struct BitBoard bbFromArray(int board[3][3]);
+
+/**
+ * @brief Returns the first winning line fully covered by a side's mask.
+ *
+ * @param mask The occupancy mask of one side.
+ * @return The mask of the completed line, or 0 if the side has no complete line.
+ */
+static inline uint16_t bbWinLine(uint16_t mask)
+{
+    return bbWinTable[mask & BB_FULL];
+}
+
+/**
+ * @brief Checks if a side's mask contains a complete line.
+ *
+ * @param mask The occupancy mask of one side.
+ * @return `true` if the side has three in a row.
+ */
+static inline bool bbIsWin(uint16_t mask)
+{
+    return bbWinLine(mask) != 0;
+}
+
+/**
+ * @brief Returns the mask of the empty cells.
+ */
+static inline uint16_t bbEmpty(struct BitBoard b)
+{
+    return (uint16_t)(~(b.bot | b.player) & BB_FULL);
+}
+
+/**
+ * @brief Pops the lowest set bit of a mask and returns its bit index.
+ *
+ * Used to walk the empty cells in row-major order:
+ * @code
+ * for (uint16_t m = bbEmpty(b); m; )
+ * {
+ *     int idx = bbPopLowest(&m);
+ *     ...
+ * }
+ * @endcode
+ */
+static inline int bbPopLowest(uint16_t *mask)
+{
+    int idx = __builtin_ctz(*mask);
+    *mask &= (uint16_t)(*mask - 1);
+    return idx;
+}
+
+/**
+ * @brief Returns the number of set bits in a mask.
+ */
+static inline int bbCount(uint16_t mask)
+{
+    return __builtin_popcount(mask);
+}
+
+/**
+ * @brief Evaluates a bitboard in the same way as the array based `evaluate()`.
+ *
+ * @return +10 if the BOT has won, -10 if PLAYER1 has won, 0 otherwise.
+ */
+static inline int bbEvaluate(struct BitBoard b)
+{
+    if (bbIsWin(b.bot))
+        return +10;
+    if (bbIsWin(b.player))
+        return -10;
+    return 0;
+}
+
+/**
+ * @brief Returns the base-3 code of a board.
+ *
+ * Cell `idx` contributes `value * 3^idx`, where value is `EMPTY`, `PLAYER1` or `BOT`,
+ * so every board maps to a unique index in `[0, BB_CODES)`.
+ */
+static inline int bbBase3(struct BitBoard b)
+{
+    int code = 0;
+    for (int idx = BB_CELLS - 1; idx >= 0; idx--)
+    {
+        code = code * 3 + ((b.player >> idx) & 1) * PLAYER1 + ((b.bot >> idx) & 1) * BOT;
+    }
+    return code;
+}
+
+#endif // BITBOARD_H
@@ -0,0 +1,103 @@
+/**
+ * @file gameDb.h
+ * @author jacktan-jk
+ * @brief Game-value database: win/loss/draw and distance to the end of every position.
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2024
+ *
+ * Written by the `solveRetrograde` tool for boards up to 4x4 and read by the engine with
+ * `mmap`. Positions are stored from the point of view of the side to move: a cell holds
+ * 1 for the side to move, 2 for its opponent and 0 when empty, and the position's index is
+ * the base-3 number formed by the cells (cell `idx` weighted `3^idx`). That way a board
+ * and its colour-swapped twin share one entry, and the file answers for whichever side
+ * the bot plays.
+ *
+ * Each entry is one byte: the result in the top two bits (`GAMEDB_WIN`, `GAMEDB_LOSS`,
+ * `GAMEDB_DRAW`, or 0 for positions that cannot occur) and the number of plies to the end
+ * of the game under perfect play in the low six bits. The winning side plays the fastest
+ * win and the losing side the slowest loss.
+ */
+
+#ifndef GAMEDB_H
+#define GAMEDB_H
+
+#include <macros.h>
+#include <logger.h>
+#include <nkBoard.h>
+
+#define GAMEDB_MAX_N 4                                    /**< Largest board with a database (3^16 entries) */
+#define GAMEDB_PATH_FMT "resources/gamevalue_%dx%d_k%d.bin" /**< File of a board size, from N, N, K */
+#define GAMEDB_MAGIC "TTTVALUE"                          /**< File signature, without terminator */
+#define GAMEDB_VERSION 1                                 /**< Format version written in the header */
+
+// Results, top two bits of an entry
+#define GAMEDB_UNKNOWN 0    /**< Position that cannot occur in a game */
+#define GAMEDB_WIN 1        /**< Side to move wins */
+#define GAMEDB_LOSS 2       /**< Side to move loses */
+#define GAMEDB_DRAW 3       /**< Nobody wins */
+
+#define GAMEDB_ENTRY(result, distance) ((uint8_t)((result) << 6 | (distance))) /**< Packs an entry */
+#define GAMEDB_RESULT(entry) ((entry) >> 6)                                     /**< Result of an entry */
+#define GAMEDB_DISTANCE(entry) ((entry) & 0x3F)                                 /**< Plies to the end */
+
+/**
+ * @struct GameDbHeader
+ * @brief Fixed header at the start of a database file, followed by `entryCount` entries.
+ */
+struct GameDbHeader
+{
+    char magic[8];        /**< `GAMEDB_MAGIC` */
+    uint32_t version;     /**< `GAMEDB_VERSION` */
+    uint8_t n;            /**< Board side */
+    uint8_t k;            /**< Number in a row needed to win */
+    uint16_t reserved;
+    uint32_t entryCount;  /**< 3^(n*n) */
+};
+
+/**
+ * @brief Returns the number of entries of a board size, `3^(n*n)`.
+ */
+uint32_t gameDbEntryCount(int n);
+
+/**
+ * @brief Returns the index of a position seen from the side to move.
+ *
+ * @param me Cells of the side to move.
+ * @param them Cells of its opponent.
+ * @param n Board side, at most `GAMEDB_MAX_N`.
+ */
+uint32_t gameDbIndex(uint64_t me, uint64_t them, int n);
+
+/**
+ * @brief Maps the database of a board size, once per process.
+ *
+ * @param n Board side.
+ * @param k Number in a row needed to win.
+ * @return `true` if the file exists and matches the size; missing files are only reported
+ *         the first time.
+ */
+bool gameDbOpen(int n, int k);
+
+/**
+ * @brief Looks up the entry of a position.
+ *
+ * @param me Cells of the side to move.
+ * @param them Cells of its opponent.
+ * @param n Board side.
+ * @param k Number in a row needed to win.
+ * @return The entry, or `GAMEDB_UNKNOWN` if the database of this size is not available.
+ */
+uint8_t gameDbProbe(uint64_t me, uint64_t them, int n, int k);
+
+/**
+ * @brief Picks the bot's move from the database: fastest win, else a draw, else slowest loss.
+ *
+ * @param b The current board, bot to move.
+ * @param bestMove Set to the chosen move.
+ * @return `true` if the database of the board's size is available and has the position.
+ */
+bool gameDbBestMove(struct NKBoard b, struct Position *bestMove);
+
+#endif // GAMEDB_H
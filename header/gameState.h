@@ -0,0 +1,133 @@
+/**
+ * @file gameState.h
+ * @author jacktan-jk
+ * @brief Incremental game state: an N x N board that knows its winner and empty cells in O(1).
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2024
+ *
+ * Next to the two occupancy masks of an `NKBoard`, the state keeps, for each side, the
+ * number of its stones in every K-cell window, how many windows it has filled and the
+ * number of empty cells. `gsMake()` and `gsUnmake()` only touch the windows through the
+ * cell played (`nkCellWindows`), so asking whether the game is won or drawn is a load
+ * instead of a scan of the board. Used by the array Minimax engine and by the GUI's
+ * `chkPlayerWin()`.
+ */
+
+#ifndef GAMESTATE_H
+#define GAMESTATE_H
+
+#include <macros.h>
+#include <nkBoard.h>
+
+#define GS_SIDE(who) ((who) - PLAYER1) /**< Counter index of `PLAYER1` or `BOT` */
+
+/**
+ * @struct GameState
+ * @brief A board with per-window stone counts, kept up to date by `gsMake()` and `gsUnmake()`.
+ */
+struct GameState
+{
+    struct NKBoard board;               /**< Occupancy masks, N and K */
+    uint8_t lineCount[2][MAX_LINES];    /**< Stones of each side in each window of `nkWindows()` */
+    int completed[2];                   /**< Windows filled by each side */
+    int emptyCount;                     /**< Empty cells left */
+};
+
+/**
+ * @brief Resets a state to the empty N x N board.
+ *
+ * @param s The state to reset.
+ * @param n Board side.
+ * @param k Number in a row needed to win.
+ */
+void gsInit(struct GameState *s, int n, int k);
+
+/**
+ * @brief Builds a state from the stones of a board.
+ *
+ * @param s The state to fill.
+ * @param b The board to copy.
+ */
+void gsFromBoard(struct GameState *s, struct NKBoard b);
+
+/**
+ * @brief Places a stone and updates the counters of the windows through its cell.
+ *
+ * @param s The state.
+ * @param cell Cell index `row * n + col`, must be empty.
+ * @param who `PLAYER1` or `BOT`.
+ */
+static inline void gsMake(struct GameState *s, int cell, int who)
+{
+    int n = s->board.n, k = s->board.k, side = GS_SIDE(who);
+    const uint8_t *windows = nkCellWindows[n][k][cell];
+    for (int i = 0; i < nkCellWindowCount[n][k][cell]; i++)
+    {
+        s->completed[side] += (++s->lineCount[side][windows[i]] == k);
+    }
+
+    if (who == BOT)
+    {
+        s->board.bot |= 1ULL << cell;
+    }
+    else
+    {
+        s->board.player |= 1ULL << cell;
+    }
+    s->emptyCount--;
+}
+
+/**
+ * @brief Takes back the stone `gsMake()` placed.
+ *
+ * @param s The state.
+ * @param cell Cell index of the stone.
+ * @param who `PLAYER1` or `BOT`, the side that placed it.
+ */
+static inline void gsUnmake(struct GameState *s, int cell, int who)
+{
+    int n = s->board.n, k = s->board.k, side = GS_SIDE(who);
+    const uint8_t *windows = nkCellWindows[n][k][cell];
+    for (int i = 0; i < nkCellWindowCount[n][k][cell]; i++)
+    {
+        s->completed[side] -= (s->lineCount[side][windows[i]]-- == k);
+    }
+
+    if (who == BOT)
+    {
+        s->board.bot &= ~(1ULL << cell);
+    }
+    else
+    {
+        s->board.player &= ~(1ULL << cell);
+    }
+    s->emptyCount++;
+}
+
+/**
+ * @brief Returns the side with K in a row: `PLAYER1`, `BOT`, or `EMPTY` if nobody has won.
+ */
+static inline int gsWinner(const struct GameState *s)
+{
+    return s->completed[GS_SIDE(PLAYER1)] ? PLAYER1 : s->completed[GS_SIDE(BOT)] ? BOT : EMPTY;
+}
+
+/**
+ * @brief Checks if every cell is taken.
+ */
+static inline bool gsIsFull(const struct GameState *s)
+{
+    return s->emptyCount == 0;
+}
+
+/**
+ * @brief Returns the mask of the empty cells.
+ */
+static inline uint64_t gsEmpty(const struct GameState *s)
+{
+    return nkEmpty(&s->board);
+}
+
+#endif // GAMESTATE_H
@@ -12,6 +12,7 @@
 #define IMPORTDATA_H
 
 #include <macros.h>
+#include <logger.h>
 
 // changed to 100 for testing. make sure to chg back
 #define RES_PATH "./resources/"       /**< Path to resources directory */
@@ -38,15 +39,18 @@ struct Dataset
  * where 'x', 'o', and 'b' represent the Bot, Player 1, and empty cells, respectively. 
  * Each board state is followed by an outcome that is stored within the dataset. 
  * If `split` is true, entries are randomized using an array of unique indices for shuffling.
+ * The entries are read into the caller's array, so concurrent readers do not share one;
+ * the dataset files themselves are shared by the whole process.
  * 
  * @param filename The name of the dataset file to read.
  * @param split Boolean indicating whether to randomize entries for dataset splitting.
+ * @param data Array the entries are read into.
  * @return int SUCCESS (0) if reading is successful, BAD_PARAM (-5) if the file cannot be opened, 
  *         or the return value of `splitFile()` if `split` is enabled.
  * 
  * @see getRandomNo, splitFile
  */
-int readDataset(const char *filename, bool split);
+int readDataset(const char *filename, bool split, struct Dataset data[DATA_SIZE]);
 
 /** 
  * @brief Splits the dataset into training and testing files with an 80-20 ratio.
@@ -56,12 +60,14 @@ int readDataset(const char *filename, bool split);
  * `testingFile`. Each entry consists of a 3x3 grid representing the Tic Tac Toe board and 
  * the outcome of that board.
  * 
+ * @param data The shuffled entries read by `readDataset()`.
+ * 
  * @return int SUCCESS (0) if both files are written successfully, BAD_PARAM (-5) if either 
  *         file cannot be opened.
  * 
- * @see data, trainingFile, testingFile
+ * @see trainingFile, testingFile
  */
-static int splitFile();
+static int splitFile(const struct Dataset data[DATA_SIZE]);
 
 /** 
  * @brief Generates an array of unique random integers within the range of the dataset size.
@@ -79,31 +85,31 @@ static void getRandomNo(int random[DATA_SIZE]);
 /** 
  * @brief Retrieves the training data from a file and returns its length.
  * 
- * This function initializes the `data` array to zero for the length of the training set, reads 
- * the dataset from the specified `trainingFile`, and assigns the `data` pointer to the provided 
- * dataset pointer. Returns the length of the training data loaded.
+ * This function initializes the `data` array to zero for the length of the training set and 
+ * reads the dataset from the specified `trainingFile` into it. Returns the length of the 
+ * training data loaded.
  * 
- * @param d Pointer to a dataset pointer that will reference the loaded training data array.
+ * @param data Array the training data is read into.
  * 
  * @return The number of training entries loaded (i.e., `len_train`).
  * 
  * @see readDataset, trainingFile
  */
-int getTrainingData(struct Dataset **d);
+int getTrainingData(struct Dataset data[DATA_SIZE]);
 
 /** 
  * @brief Retrieves the testing data from a file and returns its length.
  * 
- * This function zeroes out the `data` array for the length of the testing set, reads the 
- * dataset from the specified `testingFile`, and assigns the `data` pointer to the provided 
- * dataset pointer. Returns the length of the testing data loaded.
+ * This function zeroes out the `data` array for the length of the testing set and reads the 
+ * dataset from the specified `testingFile` into it. Returns the length of the testing data 
+ * loaded.
  * 
- * @param d Pointer to a dataset pointer that will reference the loaded testing data array.
+ * @param data Array the testing data is read into.
  * 
  * @return The number of testing entries loaded (i.e., `len_test`).
  * 
  * @see readDataset, testingFile
  */
-int getTestingData(struct Dataset **d);
+int getTestingData(struct Dataset data[DATA_SIZE]);
 
 #endif // IMPORTDATA_H
@@ -0,0 +1,117 @@
+/**
+ * @file logger.h
+ * @author jacktan-jk
+ * @brief Leveled logging that never blocks the thread writing the record.
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2024
+ *
+ * A record is formatted on the calling thread into that thread's ring buffer and written
+ * to the log file (stdout unless `logSetFile()` says otherwise) by a background thread,
+ * so a search logging every move neither takes a lock nor waits for the terminal. Each
+ * ring has one writer, its thread, and one reader, the drainer, so they only share two
+ * counters. The records of a thread come out in order; records of different threads are
+ * only ordered within roughly `LOG_DRAIN_MS`. A full ring drops `LOG_INFO()` and lower
+ * records, counting them, while errors and warnings wait for the drainer instead.
+ *
+ * `logLevel` is the most verbose level written, set with `logSetLevel()` or the
+ * `TICTACTOE_LOG` environment variable (`error`, `warn`, `info`, `debug`, `trace` or 0-4).
+ * A record above it costs one compare and a branch predicted not taken; levels above
+ * `LOG_MAX_LEVEL` (`LOG_DEBUG()` and `LOG_TRACE()` when `DEBUG` is not set) are compiled
+ * out. Records are written as formatted, without a prefix, and are cut at
+ * `LOG_MESSAGE_MAX` bytes. Everything logged is written before the process exits.
+ * @code
+ * LOG_INFO("Mapped %d positions from %s\n", count, FILE_BESTMOV);
+ * LOG_TRACE("[DEBUG] Depth exited at -> %d\n", nodes); // free unless the level is trace
+ * logSetLevel(LOG_LEVEL_WARN);
+ * @endcode
+ */
+
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <macros.h>
+#include <stdint.h>
+
+// Levels, most severe first
+#define LOG_LEVEL_ERROR 0 /**< Something failed */
+#define LOG_LEVEL_WARN 1  /**< Something was worked around */
+#define LOG_LEVEL_INFO 2  /**< Once per process or per file: tables loaded, model accuracy */
+#define LOG_LEVEL_DEBUG 3 /**< Once per move or game */
+#define LOG_LEVEL_TRACE 4 /**< Several times per move: root moves, search depths, model cells */
+
+#define LOG_MAX_LEVEL ((DEBUG) ? LOG_LEVEL_TRACE : LOG_LEVEL_INFO)     /**< Most verbose level compiled in */
+#define LOG_DEFAULT_LEVEL ((DEBUG) ? LOG_LEVEL_DEBUG : LOG_LEVEL_INFO) /**< `logLevel` unless `TICTACTOE_LOG` is set */
+#define LOG_ENV "TICTACTOE_LOG"  /**< Environment variable setting `logLevel` at startup */
+#define LOG_RING_RECORDS 256     /**< Records per thread ring, a power of two */
+#define LOG_MESSAGE_MAX 248      /**< Bytes of a record's text, the terminating NUL included */
+#define LOG_DRAIN_MS 10          /**< Longest time the drainer sleeps while records may be waiting */
+
+/** Writes a record at a level if it is compiled in and enabled. */
+#define LOG_AT(level, ...)                                                          \
+    do                                                                              \
+    {                                                                               \
+        if ((level) <= LOG_MAX_LEVEL && __builtin_expect((level) <= logLevel, 0))   \
+        {                                                                           \
+            logWrite((level), __VA_ARGS__);                                         \
+        }                                                                           \
+    } while (0)
+#define LOG_ERROR(...) LOG_AT(LOG_LEVEL_ERROR, __VA_ARGS__)
+#define LOG_WARN(...) LOG_AT(LOG_LEVEL_WARN, __VA_ARGS__)
+#define LOG_INFO(...) LOG_AT(LOG_LEVEL_INFO, __VA_ARGS__)
+#define LOG_DEBUG(...) LOG_AT(LOG_LEVEL_DEBUG, __VA_ARGS__)
+#define LOG_TRACE(...) LOG_AT(LOG_LEVEL_TRACE, __VA_ARGS__)
+
+/**
+ * @var int logLevel
+ * @brief Most verbose level written, `LOG_LEVEL_ERROR` to `LOG_LEVEL_TRACE`.
+ *
+ * Read without synchronisation by every record; change it with `logSetLevel()`.
+ */
+extern int logLevel;
+
+/**
+ * @brief Formats a record into the calling thread's ring, whatever `logLevel` is.
+ *
+ * The first record of a thread gives it a ring, reusing one of an exited thread, and the
+ * first of the process starts the drainer.
+ *
+ * @param level `LOG_LEVEL_*` of the record.
+ * @param format `printf()` format of the text.
+ */
+void logWrite(int level, const char *format, ...) __attribute__((format(printf, 2, 3)));
+
+/**
+ * @brief Sets `logLevel`, clamped to the levels that exist.
+ */
+void logSetLevel(int level);
+
+/**
+ * @brief Reads a level name or number.
+ *
+ * @param name `error`, `warn`, `info`, `debug` or `trace` in any case, or `0` to `4`.
+ * @return The `LOG_LEVEL_*`, or `ERROR` for anything else.
+ */
+int logParseLevel(const char *name);
+
+/**
+ * @brief Writes every record logged so far, then sends the next ones to another file.
+ *
+ * @param file The log file, NULL for stdout. It must stay open until the next call.
+ */
+void logSetFile(FILE *file);
+
+/**
+ * @brief Writes every record logged before the call and flushes the log file.
+ *
+ * Called at exit; call it before redirecting or reading what the log file holds.
+ */
+void logFlush();
+
+/**
+ * @brief Returns the number of records dropped because their thread's ring was full.
+ */
+uint64_t logDropped();
+
+#endif // LOGGER_H
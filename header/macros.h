@@ -33,6 +33,7 @@
 #define MODE_2P 0        /**< Two-player mode */
 #define MODE_MM 1        /**< Minimax mode */
 #define MODE_ML 2        /**< Machine Learning mode */
+#define MODE_MC 3        /**< Monte Carlo Tree Search mode */
 
 // Player identifiers
 #define EMPTY 0          /**< Empty cell */
@@ -44,17 +45,23 @@
 #define CLASSES 2        /**< Number of outcome classes */
 
 // Debugging and configuration options
-#define DEBUG 1          /**< Enable debug messages */
+#ifndef DEBUG
+#define DEBUG 1          /**< Compile in the debug and trace log records, can be set with -DDEBUG=0*/
+#endif
 #define MINIMAX_GODMODE 0/**< Minimax god mode toggle */
 #define DISABLE_LOOKUP  0/**< Disable Minimax lookup table*/
-#define DISABLE_ELAPSED 0/**< Disable Elapsed time function*/
-#define DISABLE_ASM     0/**< Disable ASM functions*/
-
-#if DEBUG
-#define PRINT_DEBUG(...) printf(__VA_ARGS__);
-#else
-#define PRINT_DEBUG(...)
+#define DISABLE_PROFILE 0/**< Compile out the profiler spans*/
+#define DISABLE_STATS   0/**< Compile out the search statistics counters*/
+#ifndef DISABLE_ASM
+#define DISABLE_ASM     0/**< Disable ASM functions, can be set with -DDISABLE_ASM=1*/
 #endif
+#define DISABLE_BITBOARD 0/**< Use the 3x3 array Minimax engine instead of the bitboard engine*/
+#define MINIMAX_ALPHABETA 1/**< Default search: 1 = alpha-beta with move ordering, 0 = plain Minimax reference*/
+#define DISABLE_TT      0/**< Disable the Minimax transposition table*/
+#define DISABLE_MOVETABLE 0/**< Disable the generated perfect-play move table*/
+#define MOVE_TIME_BUDGET_MS 50/**< Default time per bot move on N x N boards in ms, 0 = fixed depth search*/
+#define SEARCH_THREADS  0/**< Threads of the N x N search: 0 = one per core, 1 = serial*/
+#define MCTS_PLAYOUTS   0/**< Playouts per MCTS move, 0 = use the move time budget instead*/
 
 /**
  * @struct Position
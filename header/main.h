@@ -15,10 +15,14 @@
 #define MAIN_H
 #include <gtk/gtk.h>
 
+#include <pthread.h>
+
 #include <macros.h>
-#include <minimax.h>
-#include <ml-naive-bayes.h>
-#include <elapsedTime.h>
+#include <logger.h>
+#include <tictactoe.h>
+#include <profiler.h>
+
+#define PONDER_CACHE_SIZE MAX_CELLS /**< Pondered replies kept, one per empty cell at most */
 
 /*===============================================================================================
 GLOBAL DECLARATION
@@ -33,12 +37,26 @@ GLOBAL DECLARATION
  * @var int iTie_score
  * @brief Global variable to track the number of ties/draws.
  * 
- * @var int iBoard[3][3]
- * @brief Global 2D array representing the Tic-Tac-Toe game board.
+ * @var int iBoard[MAX_N][MAX_N]
+ * @brief Global 2D array representing the Tic-Tac-Toe game board (top-left N x N cells in use).
  * 
- * @var int iWinPos[3][3]
+ * @var int iWinPos[MAX_N][MAX_N]
  * @brief Global 2D array to track winning positions on the board.
  * 
+ * @var int iBoardSize
+ * @brief Board side N, 3 unless another size is given on the command line.
+ * 
+ * @var int iWinLength
+ * @brief Number in a row K needed to win, 3 unless given on the command line.
+ * 
+ * @var struct Engine *engine
+ * @brief The libtictactoe engine the bot plays with, created in `main()`.
+ * 
+ * @var struct Game *game
+ * @brief The libtictactoe game shown on the grid: a copy of `iBoard` that knows the winner
+ * and the empty cells in O(1), and the context the bot's searches run in. Every move is
+ * made on both; `clearGrid()` resets it.
+ * 
  * @var int iGameState
  * @brief Global variable to track the current game state.
  * 
@@ -54,19 +72,27 @@ GLOBAL DECLARATION
  * @brief Global flag indicating if Machine Learning mode is available.
  * This is set to false if the ML data file is missing, disabling the ML game mode.
  * 
+ * @var bool isBotThinking
+ * @brief Global flag set while a bot move is being searched; grid clicks are ignored meanwhile.
+ * 
+ * @var bool isBotWorkerAvail
+ * @brief Global flag indicating if the bot thread is running.
+ * This is set to false if the thread could not be started, the bot then thinks on the GUI thread.
+ * 
  * @var struct PlayerMode playerMode
  * @brief Global structure to track the current game mode.
  * 
  * Fields:
- * - txt: Text representation of the current mode (e.g., "2P", "MM", "ML").
+ * - txt: Text representation of the current mode (e.g., "2P", "MM", "ML", "MC").
  * - mode: Integer value representing the current game mode.
  * 
  * Player modes:
  * - MODE_2P: Player vs Player mode.
  * - MODE_MM: Minimax Bot mode.
  * - MODE_ML: Machine Learning Bot mode.
+ * - MODE_MC: Monte Carlo Tree Search Bot mode.
  * 
- * @var GtkWidget *btnGrid[3][3]
+ * @var GtkWidget *btnGrid[MAX_N][MAX_N]
  * @brief Global 2D array of buttons corresponding to the game grid.
  */
 
@@ -96,20 +122,165 @@ struct PlayerMode
 };
 
 /** 
- * @brief Executes the bot's move based on the current game mode.
+ * @struct BotJob
+ * @brief A bot move handed to the bot thread: a copy of everything the search reads.
+ */
+struct BotJob
+{
+    struct NKBoard board;   /**< Board to move on, bot to move */
+    int mode;               /**< `playerMode.mode` when the move was asked for */
+    bool isRandom;          /**< Play a random cell instead of searching (MM mode, 20% of moves) */
+    unsigned generation;    /**< Cancel count when the move was asked for */
+    gpointer data;          /**< Score button, updated when the move is played */
+};
+
+/** 
+ * @struct BotResult
+ * @brief A searched bot move on its way back to the GTK main thread.
+ */
+struct BotResult
+{
+    struct Position move;   /**< Move found, `{ERROR, ERROR}` if none */
+    unsigned generation;    /**< `BotJob::generation` of the job */
+    gpointer data;          /**< `BotJob::data` of the job */
+};
+
+/** 
+ * @struct PonderEntry
+ * @brief A bot move searched while the human was thinking, keyed by the board after the human's reply.
+ */
+struct PonderEntry
+{
+    struct NKBoard board;   /**< Board after the human's reply, bot to move */
+    int mode;               /**< Game mode the move was searched for */
+    struct Position move;   /**< The bot's move */
+};
+
+/** 
+ * @brief Starts the bot's move on the bot thread.
+ * 
+ * Copies the board and mode into a `BotJob` and rolls the 20% random Minimax move. A 
+ * searched move is then served in this order:
+ * - from the ponder cache, played at once;
+ * - from the ponder search running on this very board, played by `botWorker()` once found;
+ * - otherwise the bot thread is woken, runs `thinkBotMove()` and hands the move back with 
+ *   `g_idle_add()`, so the window keeps drawing however long the search takes.
+ * 
+ * Either way the replies still waiting to be pondered are dropped. `isBotThinking` is set 
+ * until the move is played by `onBotMoveReady()`. Without a bot thread the move is 
+ * searched and played at once.
+ * 
+ * @param data The score button, updated once the move is played.
+ * @return SUCCESS once the move is on its way.
+ * @see thinkBotMove, onBotMoveReady, cancelBotMove, botWorker, startPondering
+ */
+static int doBOTmove(gpointer data);
+
+/** 
+ * @brief Finds the bot's move based on the game mode of a job, on the bot thread.
  * 
  * In MM mode:
  * - Performs a minimax move.
- * - 20% chance of the minimax randomly selects a position.
+ * - 20% chance of the minimax randomly selects a position (`BotJob::isRandom`).
+ * 
+ * Other modes search with `gameSearch()`. The function also measures and logs the time 
+ * taken for the minimax move. It only reads the job, never the GUI state.
+ * 
+ * @param job The board and mode to move on.
+ * @return The bot's move.
+ * @see BotJob, gameSearch
+ */
+static struct Position thinkBotMove(const struct BotJob *job);
+
+/** 
+ * @brief Picks an empty cell of a board at random.
+ * 
+ * @param b The board, with at least one empty cell.
+ * @return The cell picked.
+ */
+static struct Position randomMove(const struct NKBoard *b);
+
+/** 
+ * @brief Checks if two boards have the same stones and size.
+ */
+static bool isSameBoard(const struct NKBoard *a, const struct NKBoard *b);
+
+/** 
+ * @brief Starts pondering: searching the bot's answer to every reply the human may play.
  * 
- * In ML mode, the bot uses machine learning to determine the best position.
+ * Called once the bot has moved and the game goes on, in MM and MC modes. The ponder cache 
+ * is emptied and the bot thread searches the replies one at a time, next to the stones 
+ * first, whenever it has no move or retrain to run. Each answer is stored in the cache 
+ * for `doBOTmove()`.
+ * 
+ * @see nextPonderBoard, botWorker, doBOTmove
+ */
+static void startPondering();
+
+/** 
+ * @brief Takes the next human reply to ponder off the list, on the bot thread.
  * 
- * The function also measures and logs the time taken for the minimax move.
+ * Replies that win or fill the board are skipped, the bot has no move after them.
  * 
- * @return SUCCESS if the bot's move was made successfully.
- * @see playerMode, isMLAvail, iBoard, findBestMove, getBestPosition, btnGrid
+ * @param reply Set to the board after the reply.
+ * @return `false` once every reply has been taken.
  */
-static int doBOTmove();
+static bool nextPonderBoard(struct NKBoard *reply);
+
+/** 
+ * @brief Main loop idle callback playing the move found by the bot thread.
+ * 
+ * The move is dropped if the game was reset or the mode changed since it was asked for 
+ * (`BotResult::generation` differs from the cancel count). Otherwise it is made on `iBoard` 
+ * and `game`, shown on the grid, and the turn is finished with `finishTurn()`. A search 
+ * that found no move is replaced by a random one, so the bot never skips its turn. If the 
+ * game goes on, pondering starts on the new board.
+ * 
+ * @param arg The `BotResult`, freed here.
+ * @return `G_SOURCE_REMOVE`, the callback runs once.
+ * @see doBOTmove, finishTurn, startPondering
+ */
+static gboolean onBotMoveReady(gpointer arg);
+
+/** 
+ * @brief Cancels the bot's move in progress, if any.
+ * 
+ * A move not started yet is taken off the queue, a running search is stopped through 
+ * `gameCancel()`, and a move already found is dropped by `onBotMoveReady()`. Pondering 
+ * stops as well and the ponder cache is emptied. Called by `clearGrid()`, so every reset 
+ * and mode change cancels.
+ * 
+ * @see gameCancel, onBotMoveReady
+ */
+static void cancelBotMove();
+
+/** 
+ * @brief Re-reads the ML dataset and retrains the model after a game, on the bot thread.
+ * 
+ * @see engineRetrainModel
+ */
+static void retrainML();
+
+/** 
+ * @brief Bot thread: waits for a move, a retrain request or replies to ponder and runs them.
+ * 
+ * Jobs run one at a time, so the game's search context and the ML model are only used by this thread. 
+ * A retrain comes first, then a move; one reply is pondered only when neither is waiting, 
+ * and a move asked for during a ponder search cancels it unless it is for that very board.
+ * 
+ * @param arg Unused.
+ * @return Never returns.
+ */
+static void *botWorker(void *arg);
+
+/** 
+ * @brief Ends a turn: records a win or tie, passes the turn and updates the score.
+ * 
+ * @param retVal The result of `chkPlayerWin()` after the move.
+ * @param data The score button.
+ * @see chkPlayerWin, showWin, retrainML, updateScoreBtn
+ */
+static void finishTurn(int retVal, gpointer data);
 
 /** 
  * @brief Checks the current game board for a win or tie.
@@ -119,12 +290,16 @@ static int doBOTmove();
  * - Rows
  * - Columns
  * 
+ * The winner and the empty cells are read from `game`, whose line counters
+ * are updated by every move, so the check does not scan the board. Only after a win is
+ * the winning line looked up (`gameWinLine()`) to highlight it.
+ * 
  * If there is a winning line, it marks the winning positions and returns WIN.
  * If there are no winning conditions and the board is full, it returns TIE.
  * If there are unclicked positions left, it returns PLAY.
  * 
  * @return WIN if there is a winner, TIE if the game is a tie, PLAY if the game is still ongoing.
- * @see iBoard, iWinPos
+ * @see game, gameWinLine, gameBoard, iWinPos
  */
 static int chkPlayerWin();
 
@@ -139,6 +314,7 @@ static int chkPlayerWin();
  * - Sets all button labels in the `btnGrid` to an empty string.
  * - Resets all values in the `iBoard` array to 0, indicating no moves.
  * - Resets `isPlayer1Turn` to `true`, indicating it’s Player 1's turn.
+ * - Cancels a bot move still being searched (`cancelBotMove()`) and resets `game`.
  * 
  * @see iBoard
  * @see btnGrid
@@ -182,11 +358,12 @@ static void updateScoreBtn(gpointer data);
  * - If Player 1 or Player 2 wins, the score is updated, and the win condition is shown.
  * - If the game ends in a tie, the tie score is updated.
  * - If the game is in **2P** mode, turns alternate between Player 1 and Player 2.
- * - In **MM mode**, the Minimax will automatically make a move after Player 1’s turn.
- * - In **ML mode**, the dataset is re-read and initialized after the game ends.
+ * - In **MM mode**, the Minimax will automatically make a move after Player 1’s turn. The move is 
+ *   searched on the bot thread and clicks are ignored until it is played (`isBotThinking`).
+ * - In **ML mode**, the dataset is re-read and initialized after the game ends, on the bot thread.
  * 
  * @see iBoard, isPlayer1Turn, iPlayer1_score, iPlayer2_score, iTie_score
- * @see playerMode, updateScoreBtn, chkPlayerWin, doBOTmove, showWin
+ * @see playerMode, updateScoreBtn, chkPlayerWin, doBOTmove, finishTurn, showWin
  * @see PLAY, TIE, WIN
  */
 void on_btnGrid_clicked(GtkWidget *widget, gpointer data);
@@ -194,7 +371,8 @@ void on_btnGrid_clicked(GtkWidget *widget, gpointer data);
 /** 
  * @brief Handles button click for score.
  * 
- * Toggles the player mode and updates the displayed score.
+ * Toggles the player mode (2P, MM, ML, MC) and updates the displayed score. ML is skipped
+ * when the dataset is missing or the board is not 3x3.
  * 
  * @param widget The widget that triggered the event.
  * @param data Additional data passed to the callback.
@@ -0,0 +1,86 @@
+/**
+ * @file mcts.h
+ * @author jacktan-jk
+ * @brief Monte Carlo Tree Search bot for N x N boards won by K in a row.
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2024
+ *
+ * Each iteration walks down the tree picking the child with the best UCT score, adds one
+ * untried move as a new node, plays the game out with uniformly random moves on an
+ * `NKBoard` and adds the result to every node on the path. The bot then plays the most
+ * visited root move.
+ *
+ * The search is root-parallel: every thread grows its own tree from the same root with
+ * its own random number generator, and the visit counts of the root moves are summed at
+ * the end. Each thread's nodes come from a block kept in the search context. A block starts
+ * at `MCTS_POOL_CHUNK` nodes and doubles as the tree grows, up to `MCTS_POOL_NODES`, or up
+ * to one node per playout when `mctsPlayouts` is set; blocks are kept for the next move, so
+ * a search rarely allocates. Once a tree's block is full it stops growing and keeps running
+ * playouts from its leaves.
+ */
+
+#ifndef MCTS_H
+#define MCTS_H
+
+#include <macros.h>
+#include <logger.h>
+#include <nkBoard.h>
+#include <threadPool.h>
+
+#define MCTS_POOL_NODES (1 << 18)   /**< Most nodes of each thread's tree */
+#define MCTS_POOL_CHUNK (1 << 12)   /**< Nodes of a thread's first block */
+#define MCTS_UCT_C 1.41421356f      /**< UCT exploration constant, sqrt(2) */
+#define MCTS_CLOCK_INTERVAL 256     /**< Playouts between two reads of the clock */
+
+/**
+ * @struct MCTSNode
+ * @brief One node of a search tree; links are indexes into the thread's node pool.
+ */
+struct MCTSNode
+{
+    uint64_t untried;   /**< Candidate moves not expanded yet */
+    int parent;         /**< Parent node, `ERROR` for the root */
+    int firstChild;     /**< First expanded child, `ERROR` if none */
+    int nextSibling;    /**< Next child of the same parent, `ERROR` if last */
+    int8_t move;        /**< Cell index of the move leading here, `ERROR` at the root */
+    bool isBotMove;     /**< Whether the BOT made `move` */
+    uint32_t visits;    /**< Playouts through this node */
+    float wins;         /**< Playout results for the side that made `move`: 1 win, 0.5 draw */
+};
+
+/**
+ * @var int mctsPlayouts
+ * @brief Playouts per move summed over all threads, or 0 to search for `searchTimeBudget`
+ * milliseconds instead. Defaults to `MCTS_PLAYOUTS`; a `SearchContext` has its own copy. With both at 0 each thread makes
+ * one batch of `MCTS_CLOCK_INTERVAL` playouts.
+ */
+extern int mctsPlayouts;
+
+/**
+ * @brief Finds the bot's move with Monte Carlo Tree Search.
+ *
+ * Runs on `searchThreadCount()` threads until `mctsPlayouts` playouts have been made, or
+ * until `searchTimeBudget` milliseconds have passed if `mctsPlayouts` is 0, taking both
+ * from the current `SearchContext`. It also stops, with a move to throw away, once the
+ * context is cancelled. The number of playouts and
+ * playouts per second are logged at `LOG_LEVEL_DEBUG`.
+ *
+ * @param b The current board, bot to move.
+ * @return The most visited move, or `{ERROR, ERROR}` if the board has no empty cell.
+ *
+ * @see mctsRun
+ */
+struct Position findBestMoveMCTS(struct NKBoard b);
+
+/**
+ * @brief Runs a search and also returns the total number of playouts, for benchmarks.
+ *
+ * @param b The current board, bot to move.
+ * @param playouts Set to the number of playouts made by all threads.
+ * @return The most visited move.
+ */
+struct Position mctsRun(struct NKBoard b, long *playouts);
+
+#endif // MCTS_H
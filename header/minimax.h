@@ -17,23 +17,191 @@
 #define MINIMAX_H
 
 #include <macros.h>  /**< Include macro definitions */
-#include <elapsedTime.h>
+#include <logger.h>
+#include <profiler.h>
+#include <searchStats.h>
+#include <bitboard.h>
+#include <nkBoard.h>
+#include <transposition.h>
+#include <threadPool.h>
+#include <moveTable.h>
+#include <bestMoveStore.h>
+#include <gameDb.h>
+#include <gameState.h>
 
-/** 
- * @brief Stores the current state of the Tic-Tac-Toe board along with the best move.
- * 
- * This structure holds a 3x3 board array and the best move associated with that 
- * board state. It is used for storing and comparing previous board states and their 
- * corresponding optimal moves.
+#define SEARCH_MINIMAX 0    /**< Plain Minimax, searches the full tree (reference mode) */
+#define SEARCH_ALPHABETA 1  /**< Alpha-beta pruning with move ordering */
+#define MAX_PLY (BB_CELLS + 1) /**< Maximum search ply, used to size the killer move table */
+#define KILLER_BONUS 1000000  /**< Ordering bonus of a killer move, above any history score */
+
+#define MINIMAX_ENGINE_VERSION 1 /**< Version of the 3x3 engine's moves in the best move file, bump when they change */
+#define NO_DEPTH_LIMIT -1     /**< `searchDepthLimit` value for a full-depth (god mode) search */
+#define MINIMAX_DEPTH_LIMIT 2 /**< Depth cap used when Minimax god mode is disabled */
+#define TT_FULL_DEPTH 0xFF    /**< Transposition table depth tag of full-depth scores */
+
+/** Depth tag of a transposition table entry: the plies left before the depth cap. A
+ * depth-capped score is only reusable with as many plies left, whatever limit and ply it
+ * was found at; with `BB_CELLS` or more left nothing is cut, so the score is full-depth. */
+#define TT_DEPTH(depth)                                                                   \
+    (searchCtx->depthLimit == NO_DEPTH_LIMIT || searchCtx->depthLimit - (depth) >= BB_CELLS \
+         ? TT_FULL_DEPTH                                                                  \
+         : searchCtx->depthLimit - (depth))
+
+#define NK_MAX_PLY (MAX_CELLS + 1) /**< Maximum ply of the N x N search */
+#define NK_CLOCK_INTERVAL 1024     /**< Nodes searched between two reads of the clock in a timed search */
+
+struct MCTSNode;
+
+/**
+ * @struct SearchContext
+ * @brief Settings and running state of the searches made for one game.
+ *
+ * A search reads its settings from the context it runs in and keeps its deadline, abort
+ * flag, worker pool and MCTS nodes there, so searches in different contexts can run at
+ * the same time on different threads. A thread enters a context with `searchEnter()`;
+ * outside of one, searches run in a process-wide default context that takes its settings
+ * from `searchMode`, `searchDepthLimit`, `searchTimeBudget`, `searchThreads` and
+ * `mctsPlayouts` at every call. The transposition table, move table and databases stay
+ * shared by all contexts.
  */
-struct BoardState
+struct SearchContext
 {
-    int board[3][3]; /**< The Tic-Tac-Toe board */
-    struct Position bestMove; /**< The best move for the bot */
+    int mode;                  /**< `SEARCH_MINIMAX` or `SEARCH_ALPHABETA`, see `searchMode` */
+    int depthLimit;            /**< See `searchDepthLimit` */
+    int timeBudget;            /**< See `searchTimeBudget` */
+    int threads;               /**< See `searchThreads` */
+    int mctsPlayouts;          /**< See `mctsPlayouts` */
+    volatile bool cancelled;   /**< Set by another thread to stop the running search */
+    volatile bool stopped;     /**< Set by another thread to end a timed search with its best move so far */
+
+    struct timespec deadline;  /**< Time the running timed search must stop at */
+    volatile bool aborted;     /**< Set once the deadline passes, unwinds every thread */
+    bool timed;                /**< Whether the running search has a deadline */
+    unsigned searchId;         /**< Id of the running N x N search, resets the move ordering tables */
+    struct ThreadPool *pool;   /**< `threads - 1` workers, started on first use */
+    struct MCTSNode *nodePools[POOL_MAX_THREADS + 1]; /**< MCTS node block of each thread, grown on use */
+    int nodePoolSizes[POOL_MAX_THREADS + 1];         /**< Nodes allocated in each of `nodePools` */
+    struct SearchStats stats;  /**< Statistics of the last bot move searched in the context */
 };
 
-#define FILE_BESTMOV "resources/bestmove.txt" /**< Path to the file storing best moves */
-#define MAX_BOARDS 10000 /**< Maximum number of boards to store in memory */
+/**
+ * @struct NKRootJob
+ * @brief State shared by the threads of one parallel root search.
+ */
+struct NKRootJob
+{
+    struct SearchContext *ctx;   /**< Context of the search, entered by every task */
+    struct NKBoard board;        /**< Root position, copied by every task */
+    int depth;                   /**< Depth of the iteration */
+    uint64_t key;                /**< Zobrist key of the root */
+    int bestVal;                 /**< Best root score so far, read atomically as every task's alpha */
+    int bestMove;                /**< Cell index of `bestVal`, guarded by `lock` */
+    pthread_mutex_t lock;
+    struct SearchStats stats;    /**< Counters of all tasks, guarded by `lock` */
+    int moveVals[MAX_CELLS];     /**< Running minimum over the replies of a split root move */
+    int repliesLeft[MAX_CELLS];  /**< Replies of a split root move not finished yet */
+};
+
+/**
+ * @struct NKRootTask
+ * @brief One unit of work of a parallel root search: a root move, or a root move and a reply.
+ */
+struct NKRootTask
+{
+    struct NKRootJob *job;
+    int move;   /**< Root move, cell index */
+    int reply;  /**< Reply to search, or `ERROR` to search the whole root move */
+};
+
+/** Win scores count down with the ply they are found at, so the transposition table stores
+ * them relative to the node instead of the root. */
+#define NK_SCORE_TO_TT(score, ply) \
+    ((score) > NK_WIN_SCORE / 2 ? (score) + (ply) : (score) < -NK_WIN_SCORE / 2 ? (score) - (ply) : (score))
+#define NK_SCORE_FROM_TT(score, ply) \
+    ((score) > NK_WIN_SCORE / 2 ? (score) - (ply) : (score) < -NK_WIN_SCORE / 2 ? (score) + (ply) : (score))
+
+/**
+ * @var int searchMode
+ * @brief Search used by `findBestMove()` on the bitboard engine.
+ *
+ * Either `SEARCH_MINIMAX` or `SEARCH_ALPHABETA`. Defaults to `MINIMAX_ALPHABETA` and can be
+ * changed at runtime to compare node counts between the two modes; the number of nodes
+ * visited by each search is logged at `LOG_LEVEL_DEBUG` and reported by `searchLastStats()`.
+ *
+ * @var int searchDepthLimit
+ * @brief Deepest ply searched before a non-terminal node scores 0, or `NO_DEPTH_LIMIT`.
+ *
+ * Defaults to `NO_DEPTH_LIMIT` when `MINIMAX_GODMODE` is set and to `MINIMAX_DEPTH_LIMIT`
+ * otherwise, matching the original `depth > 2` cut-off. It also selects which generated
+ * move table `findBestMove()` reads from; other limits always search.
+ *
+ * @var int searchTimeBudget
+ * @brief Time in milliseconds the bot may spend on a move on N x N boards.
+ *
+ * Defaults to `MOVE_TIME_BUDGET_MS`. When positive, `findBestMoveNK()` deepens the search
+ * one ply at a time until the budget runs out (`searchTimedNK()`); 0 searches to the fixed
+ * `nkSearchDepth()` instead.
+ *
+ * @var int searchThreads
+ * @brief Number of threads searching N x N boards.
+ *
+ * Defaults to `SEARCH_THREADS`; 0 uses one thread per core and 1 keeps the serial search.
+ *
+ * @var struct SearchContext *searchCtx
+ * @brief Context of the search running on this thread, NULL before the first one.
+ */
+extern int searchMode;
+extern int searchDepthLimit;
+extern int searchTimeBudget;
+extern int searchThreads;
+extern __thread struct SearchContext *searchCtx;
+
+/**
+ * @brief Sets up a context with the current default settings and nothing running.
+ *
+ * @param ctx The context to fill.
+ */
+void searchContextInit(struct SearchContext *ctx);
+
+/**
+ * @brief Stops the workers and frees the MCTS nodes of a context no search runs in.
+ *
+ * @param ctx The context to release; it can be used again afterwards.
+ */
+void searchContextRelease(struct SearchContext *ctx);
+
+/**
+ * @brief Makes the calling thread's searches run in a context until `searchLeave()`.
+ *
+ * Setting `SearchContext::cancelled` stops a search of the context early: it unwinds as
+ * if its time had run out and its move must be thrown away. The flag stays set until the
+ * owner of the context clears it before starting the next search.
+ *
+ * @param ctx The context to enter. Only one thread at a time may search in it.
+ * @return The context entered before, to hand to `searchLeave()`.
+ */
+struct SearchContext *searchEnter(struct SearchContext *ctx);
+
+/**
+ * @brief Returns to the context `searchEnter()` replaced.
+ */
+void searchLeave(struct SearchContext *outer);
+
+/**
+ * @brief Returns the context the calling thread searches in, the default one if it
+ * entered none, and makes it `searchCtx`.
+ */
+struct SearchContext *searchContext();
+
+/**
+ * @brief Copies the statistics of the last bot move searched in the calling thread's context.
+ *
+ * Set when `findBestMove()` or `findBestMoveNK()` returns, whichever table or search gave
+ * the move; all zero before the first one.
+ *
+ * @param stats Set to the statistics.
+ */
+void searchLastStats(struct SearchStats *stats);
 
 /**
  * @brief Returns the maximum of two integers.
@@ -88,20 +256,146 @@ static int min(int a, int b);
 /**  
  * @brief Finds the best move for the bot in the Tic-Tac-Toe game.
  * 
- * This function first checks if the best move is already stored in memory by 
- * looking through previous board states. If the move is found, it is returned. 
- * If no best move is found in memory, it traverses all the empty cells on the 
- * board, evaluates the potential moves using the minimax algorithm, and returns 
- * the optimal move.
+ * Unless `DISABLE_MOVETABLE` is set, the move is read from the table generated by 
+ * `genMoveTable` at build time (`moveTableGodmode` or `moveTableDepthLimited`, depending 
+ * on `searchDepthLimit`), indexed by the base-3 code of the board. This is a single array 
+ * load with no file I/O and covers every position the bot can be asked to play.
+ * 
+ * Next, when searching without a depth limit, the move is picked from the game-value 
+ * database written by `solveRetrograde` if its file is present (`gameDbBestMove()`).
+ * 
+ * Otherwise this function checks if the best move is already stored in the mapped 
+ * best move file (`checkAndUpdateBestMove()`). If the move is found, it is returned. 
+ * If not, it searches the position with `searchBestMove()` and stores the result in 
+ * the board's slot of the file.
+ * 
+ * What the call cost, and which of these gave the move, is kept for `searchLastStats()`.
  * 
  * @param board A 3x3 array representing the current Tic-Tac-Toe board.
  * 
  * @return The best move for the bot as a struct Position containing the row and column.
  * 
- * @see minimax, loadBoardStates, checkAndUpdateBestMove, writeBestMoveToFile
+ * @see searchBestMove, moveTableGodmode, moveTableDepthLimited, gameDbBestMove, loadBoardStates, checkAndUpdateBestMove, writeBestMoveToFile
  */
 struct Position findBestMove(int board[3][3]);
 
+/**
+ * @brief Searches a position for the bot's best move, bypassing every lookup table.
+ *
+ * Traverses all the empty cells on the board, evaluates the potential moves using the 
+ * minimax algorithm, and returns the optimal move. The search runs on the bitboard engine 
+ * (`bbMinimax`) unless `DISABLE_BITBOARD` is set, in which case the 3x3 array engine 
+ * (`minimax`) is used. On the bitboard engine `searchMode` selects between plain Minimax 
+ * (`bbMinimax`) and alpha-beta (`bbAlphaBeta`); the node count of the search is logged 
+ * at `LOG_LEVEL_DEBUG`. Used by `findBestMove()` and by `genMoveTable` to solve every position.
+ *
+ * @param board A 3x3 array representing the current Tic-Tac-Toe board.
+ *
+ * @return The best move, or `{ERROR, ERROR}` if the board has no empty cell.
+ *
+ * @see minimax, bbMinimax, bbAlphaBeta, searchMode, searchDepthLimit
+ */
+struct Position searchBestMove(int board[3][3]);
+
+/**
+ * @brief Finds the best move for the bot on an N x N board won by K in a row.
+ *
+ * The 3x3 board is handed to `findBestMove()` so it keeps its move table and lookup file.
+ * Boards with a game-value database on disk (4x4, see `solveRetrograde`) play from it.
+ * Larger boards cannot be searched to the end and score the leaves with `nkEvaluate()`.
+ * They are searched with iterative deepening for `searchTimeBudget` milliseconds
+ * (`searchTimedNK()`), or to the fixed `nkSearchDepth()` if the budget is 0.
+ *
+ * @param b The current board, bot to move.
+ * @return The best move, or `{ERROR, ERROR}` if the board has no empty cell.
+ *
+ * @see findBestMove, gameDbBestMove, searchTimedNK, searchBestMoveNK, nkSearchDepth
+ */
+struct Position findBestMoveNK(struct NKBoard b);
+
+/**
+ * @brief Default search depth of a board size.
+ *
+ * 4x4 boards are searched to the end. Larger sizes are capped so no move of a self-play
+ * game takes more than a few hundred milliseconds with `-O2`.
+ *
+ * @param n Board side.
+ * @param k Number in a row needed to win.
+ * @return The depth in plies.
+ */
+int nkSearchDepth(int n, int k);
+
+/**
+ * @brief Depth-limited alpha-beta search of an N x N board.
+ *
+ * @param b The current board, bot to move.
+ * @param depth Number of plies to search before evaluating.
+ * @return The best move, or `{ERROR, ERROR}` if the board has no empty cell.
+ *
+ * @see nkAlphaBeta
+ */
+struct Position searchBestMoveNK(struct NKBoard b, int depth);
+
+/**
+ * @brief Iterative deepening alpha-beta search of an N x N board under a time budget.
+ *
+ * Searches depth 1, 2, 3, ... until the budget runs out, a forced win or loss is found or
+ * every empty cell is covered. Each iteration tries the previous best move first, and
+ * the killer, history and transposition tables it filled make the next one cheaper.
+ * The clock is read every `NK_CLOCK_INTERVAL` nodes; once the deadline passes the running
+ * iteration unwinds and its partial result is discarded, so the move returned is the one
+ * of the deepest completed iteration. Depth 1 is never aborted.
+ *
+ * @param b The current board, bot to move.
+ * @param budgetMs Time allowed for the move in milliseconds.
+ * @return The best move, or `{ERROR, ERROR}` if the board has no empty cell.
+ *
+ * @see nkSearchRoot, nkTimeUp
+ */
+struct Position searchTimedNK(struct NKBoard b, int budgetMs);
+
+/**
+ * @brief Counts the positions `depth` plies below a 3x3 array board (perft).
+ *
+ * Walks the game tree the way the array engine did before `GameState`: moves are made and 
+ * undone in place, `evaluate()` rescans the 8 lines and `isMovesLeft()` the 9 cells at every node, 
+ * so it measures the original array scan with or without the `DISABLE_ASM` helpers. A won 
+ * or full board ends the game and is not expanded.
+ *
+ * @param board A 3x3 array representing the board, restored before returning.
+ * @param depth Number of plies to walk.
+ * @param isMax Whether the bot is the side to move.
+ * @return Number of positions reached after exactly `depth` plies.
+ *
+ * @see perftGameState, perftBitBoard, perftNK
+ */
+long perftArray(int board[3][3], int depth, bool isMax);
+
+/**
+ * @brief Counts the positions `depth` plies below a game state, like `perftArray()`.
+ *
+ * Uses the same make/unmake and constant-time win and draw tests as `minimax()`.
+ *
+ * @see perftArray, gsMake, gsWinner
+ */
+long perftGameState(struct GameState *s, int depth, bool isMax);
+
+/**
+ * @brief Counts the positions `depth` plies below a bitboard, like `perftArray()`.
+ *
+ * @see perftArray, bbIsWin, bbEmpty
+ */
+long perftBitBoard(struct BitBoard b, int depth, bool isMax);
+
+/**
+ * @brief Counts the positions `depth` plies below an N x N board, like `perftArray()`.
+ *
+ * Every empty cell is a move, not only the neighbours the search generates.
+ *
+ * @see perftArray, nkHasWin, nkEmpty
+ */
+long perftNK(struct NKBoard b, int depth, bool isMax);
+
 /**  
  * @brief Implements the Minimax algorithm to evaluate the best move for the bot.
  * 
@@ -109,18 +403,224 @@ struct Position findBestMove(int board[3][3]);
  * algorithm. It returns the best score for the current player (maximizer or 
  * minimizer) based on the game state. The algorithm chooses the optimal move 
  * for the bot and evaluates the game state at each depth. The depth is capped 
- * if Minimax Godmode is not enabled. If there are no moves left or the game 
+ * at `searchDepthLimit` if Minimax Godmode is not enabled. If there are no moves left or the game 
  * is over, it returns the evaluation score.
  * 
- * @param board A 3x3 array representing the current Tic-Tac-Toe board.
+ * Moves are made and taken back with `gsMake()` and `gsUnmake()` on one `GameState`, which 
+ * keeps the per-line counters up to date, so the win and draw tests at each node are 
+ * constant-time lookups (`gsWinner()`, `gsIsFull()`) instead of rescanning the board.
+ * 
+ * @param s The game state to search from, restored before returning.
  * @param depth The current depth in the game tree.
  * @param isMax Boolean flag indicating whether it is the maximizer's turn (bot) or the minimizer's turn (player).
  * 
- * @return The best score for the current move based on the evaluation function.
+ * @return +10 for a bot win, -10 for a player win, 0 for a draw or a node past the depth cap.
  * 
- * @see evaluate, isMovesLeft, max, min
+ * @see gsMake, gsUnmake, gsWinner, gsIsFull, max, min
  */
-static int minimax(int board[3][3], int depth, bool isMax);
+#if DISABLE_BITBOARD
+static int minimax(struct GameState *s, int depth, bool isMax);
+#endif
+
+/**
+ * @brief Bitboard implementation of the Minimax algorithm.
+ *
+ * Behaves exactly like `minimax()` (same scores, same depth cap when Minimax Godmode
+ * is disabled and same move order) but works on a `BitBoard`. Terminal positions are
+ * detected against the precomputed `bbWinMasks` table and empty cells are iterated with
+ * count-trailing-zeros, so no node rescans the 3x3 array. Only the side that made the
+ * last move is tested for a win. The 4-byte board is passed by value so each child is
+ * built in registers and there is no undo step.
+ * 
+ * Unless `DISABLE_TT` is set, every non-terminal node is looked up in the symmetry-aware
+ * transposition table first and its exact score is stored once searched.
+ *
+ * @param b The bitboard to search from.
+ * @param depth The current depth in the game tree.
+ * @param isMax Boolean flag indicating whether it is the maximizer's turn (bot) or the minimizer's turn (player).
+ *
+ * @return The best score for the current move based on `bbEvaluate()`.
+ *
+ * @see minimax, bbEvaluate, bbEmpty, bbPopLowest
+ */
+static int bbMinimax(struct BitBoard b, int depth, bool isMax);
+
+/**
+ * @brief Bitboard Minimax with alpha-beta pruning.
+ *
+ * Returns the same value as `bbMinimax()` for any window containing the true score, but
+ * stops searching a node once the opponent already has a better alternative elsewhere
+ * (`alpha >= beta`). Children are searched in the order returned by `bbOrderMoves()`.
+ * When a move causes a cutoff it is stored as a killer move for its ply and its history
+ * score is increased by the square of the remaining depth, so it is tried first at sibling
+ * nodes.
+ * 
+ * Unless `DISABLE_TT` is set, each node probes the transposition table: an exact entry is
+ * returned directly and a bound entry narrows the window. The result is stored as exact,
+ * lower bound (failed high) or upper bound (failed low) relative to the original window.
+ *
+ * @param b The bitboard to search from.
+ * @param depth The current depth in the game tree.
+ * @param alpha The score the maximizer (bot) is already guaranteed.
+ * @param beta The score the minimizer (player) is already guaranteed.
+ * @param isMax Boolean flag indicating whether it is the maximizer's turn (bot) or the minimizer's turn (player).
+ *
+ * @return The best score for the current move, or a bound on it if a cutoff occurred.
+ *
+ * @see bbMinimax, bbOrderMoves, killerMoves, historyTable, ttProbe, ttStore
+ */
+static int bbAlphaBeta(struct BitBoard b, int depth, int alpha, int beta, bool isMax);
+
+/**
+ * @brief Lists the empty cells of a bitboard in search order.
+ *
+ * Moves are sorted by killer move first, then history score, then the static cell
+ * priority: center, corners and finally edges.
+ *
+ * @param b The bitboard to generate moves for.
+ * @param ply The ply of the node being expanded, used to look up killer moves.
+ * @param isMax Whether the bot (maximizer) is the side to move.
+ * @param moves Output array of bit indexes, best candidate first.
+ *
+ * @return The number of moves written to `moves`.
+ *
+ * @see bbAlphaBeta, bbCellPriority
+ */
+static int bbOrderMoves(struct BitBoard b, int ply, bool isMax, int moves[BB_CELLS]);
+
+/**
+ * @brief Searches every root move of an N x N board to a fixed depth.
+ *
+ * The moves are handed to `nkSearchRootParallel()` when the context has `searchWorkers()`,
+ * and searched in turn on the calling thread otherwise, also when no worker could start.
+ *
+ * @param b The current board, bot to move.
+ * @param depth Number of plies to search.
+ * @param firstMove Cell index to search first (the previous iteration's best), or `ERROR`.
+ * @param bestMove Set to the best move found.
+ * @return The score of the best move; meaningless if `SearchContext::aborted` was set.
+ */
+static int nkSearchRoot(struct NKBoard b, int depth, int firstMove, struct Position *bestMove);
+
+/**
+ * @brief Returns the number of threads a search of the current context uses, resolving
+ * 0 threads to the number of cores and clamping to `POOL_MAX_THREADS`.
+ */
+int searchThreadCount();
+
+/**
+ * @brief Returns the worker pool shared by the parallel searches.
+ *
+ * The pool has `searchThreadCount() - 1` workers, as the calling thread also runs tasks
+ * in `poolWait()`. Each context has its own pool, since `poolWait()` waits for every task
+ * of the pool. It is started on first use, restarted when the thread count changes, and
+ * kept until `searchContextRelease()`.
+ *
+ * @return The pool, or NULL for a single-threaded search or if no worker could be started.
+ */
+struct ThreadPool *searchWorkers();
+
+/**
+ * @brief Searches the root moves of an N x N board on `searchThreads` threads.
+ *
+ * The first move of `moves` (the previous iteration's best) is searched on the calling
+ * thread to get a bound. The remaining root moves are then queued on the work-stealing
+ * `searchWorkers()` pool, which the caller has started. If there are fewer of them than twice the thread count, each one is
+ * split further into one task per reply. Every task copies the board and searches with
+ * the shared best score (`NKRootJob::bestVal`) as its alpha, so a better root move found
+ * by one thread narrows the window of the others. Killer moves, history and node counts
+ * are thread-local; the transposition table is shared.
+ *
+ * Ties between equally scored root moves may resolve differently from the serial search.
+ *
+ * @param b The current board, bot to move.
+ * @param depth Number of plies to search.
+ * @param key Zobrist key of `b`.
+ * @param moves Root moves in search order.
+ * @param moveCount Number of root moves, at least 2.
+ * @param bestMove Set to the best move found.
+ * @return The score of the best move.
+ *
+ * @see nkRootTask, poolSubmit
+ */
+static int nkSearchRootParallel(struct NKBoard b, int depth, uint64_t key, int moves[MAX_CELLS], int moveCount,
+                                struct Position *bestMove);
+
+/**
+ * @brief Thread pool entry point searching one `NKRootTask`.
+ */
+static void nkRootTask(void *arg);
+
+/**
+ * @brief Records a finished root move if it beats the shared best score.
+ */
+static void nkRootResult(struct NKRootJob *job, int move, int score);
+
+/**
+ * @brief Clears the calling thread's killer and history tables if they belong to an
+ * earlier search.
+ */
+static void nkPrepareThread();
+
+/**
+ * @brief Checks the deadline of a timed search every `NK_CLOCK_INTERVAL` calls.
+ *
+ * A cancelled search (`SearchContext::cancelled`) counts as out of time at once, timed or not.
+ *
+ * @return `true` once the deadline has passed; `SearchContext::aborted` is set as well.
+ */
+static bool nkTimeUp();
+
+/**
+ * @brief Ends the calling thread's statistics of a bot move and keeps them in its context.
+ *
+ * Logs the nodes of a searched move at `LOG_LEVEL_DEBUG`, once per move; the searches
+ * themselves only log at `LOG_LEVEL_TRACE`, as their callers may not clear the statistics.
+ *
+ * @param source `STATS_SOURCE_*` the move came from.
+ * @param move The move found.
+ * @return `move`.
+ */
+static struct Position searchFinish(int source, struct Position move);
+
+/**
+ * @brief Alpha-beta search of an N x N board.
+ *
+ * Same algorithm as `bbAlphaBeta()` on an `NKBoard`: the last mover is tested for a win
+ * with the size-specialised `nkHasWin()`, leaves at the depth limit are scored by
+ * `nkEvaluate()`, and children are tried in `nkOrderMoves()` order. The Zobrist key is
+ * passed down and updated with `ttMoveKeyNK()` rather than recomputed at every node.
+ * In a timed search every node polls `nkTimeUp()` and returns at once after an abort,
+ * without storing anything in the transposition table.
+ *
+ * @param b The board to search from.
+ * @param ply Number of moves made since the root.
+ * @param depthLeft Plies left before the heuristic is used; also the transposition table depth.
+ * @param alpha The score the maximizer (bot) is already guaranteed.
+ * @param beta The score the minimizer (player) is already guaranteed.
+ * @param isMax Whether the bot is to move.
+ * @param key Zobrist key of `b` with the side to move.
+ *
+ * @return The score of the position, `NK_WIN_SCORE - ply` for a bot win found at `ply`.
+ *
+ * @see bbAlphaBeta, nkOrderMoves, nkEvaluate
+ */
+static int nkAlphaBeta(struct NKBoard b, int ply, int depthLeft, int alpha, int beta, bool isMax, uint64_t key);
+
+/**
+ * @brief Lists the candidate cells of an N x N board in search order.
+ *
+ * Only empty cells next to a stone are generated (`nkNeighbours()`). They are sorted by
+ * killer move, then history score, then closeness to the centre.
+ *
+ * @param b The board to generate moves for.
+ * @param ply The ply of the node being expanded, used to look up killer moves.
+ * @param isMax Whether the bot is the side to move.
+ * @param moves Output array of cell indexes, best candidate first.
+ *
+ * @return The number of moves written to `moves`.
+ */
+static int nkOrderMoves(const struct NKBoard *b, int ply, bool isMax, int moves[MAX_CELLS]);
 
 /**  
  * @brief Evaluates the current board state to determine if there is a winner.
@@ -176,61 +676,6 @@ static int evaluate(int b[3][3]);
  */
 static bool isMovesLeft(int board[3][3]);
 
-/**  
- * @brief Checks if the current board configuration exists in the lookup table and updates the best move.
- * 
- * This function compares the current board with previously saved board states in the `boardStates` array. 
- * If a matching board configuration is found, it updates the provided `bestMove` structure with the best 
- * move associated with that board state. The function returns true if a match is found and the move is updated, 
- * and false if no match is found in the lookup table.
- * 
- * @param board The current Tic Tac Toe board to check against the saved states.
- * @param bestMove A pointer to the `Position` structure where the best move will be stored if a match is found.
- * @param boardStates An array of `BoardState` structures containing previously saved board configurations and their best moves.
- * @param count The number of saved board states in the `boardStates` array.
- * 
- * @return `true` if a matching board configuration is found and the best move is updated, `false` otherwise.
- * 
- * @see BoardState, Position
- */
-static bool checkAndUpdateBestMove(int board[3][3], struct Position *bestMove, struct BoardState boardStates[], int count);
-
-/**  
- * @brief Appends the current board state and the best move to a file.
- * 
- * This function writes the current Tic Tac Toe board state to a file, encoding the board as a sequence of 
- * characters where 'o' represents Player 1, 'x' represents the Bot, and 'b' represents an empty cell. 
- * After writing the board state, it appends the best move (row and column) for the current board to the same file.
- * 
- * @param board The current Tic Tac Toe board to write to the file.
- * @param bestMove The best move to be made, represented by its row and column indices.
- * 
- * @see Position, BoardState
- */
-static void writeBestMoveToFile(int board[3][3], struct Position bestMove);
-
-/**  
- * @brief Loads board states and their best moves from a file.
- * 
- * This function attempts to open a file containing saved board states and the 
- * corresponding best move for each state. If the file does not exist, a new 
- * file is created. It reads the board configurations and the best move 
- * for each board, storing them in the provided `boardStates` array.
- * 
- * Each line in the file represents one board state. The board is stored as 
- * a 3x3 grid, where 'x' denotes the BOT's move, 'o' denotes PLAYER1's move, 
- * and empty spaces are represented as ' ' (empty). The best move for each 
- * board is also saved in the file.
- * 
- * @param boardStates An array of `BoardState` structures to store the loaded board states.
- * 
- * @return The number of boards loaded from the file. If the file does not exist, 
- *         it returns 0 and creates a new file.
- * 
- * @see BoardState, FILE_BESTMOV
- */
-static int loadBoardStates(struct BoardState boardStates[]);
-
 /** 
  * @brief Prints the contents of the best move file.
  * 
@@ -26,42 +26,25 @@
 #define CLASSES 2                              /**< Number of possible outcome classes (positive/negative) */
 
 /**
- * @var positive_count
- * @brief Counter for the number of positive outcomes in the training dataset.
- * 
- * @var negative_count
- * @brief Counter for the number of negative outcomes in the training dataset.
- * 
- * @var positiveClassProbability
- * @brief Probability of a positive outcome in the dataset.
- * 
- * @var negativeClassProbability
- * @brief Probability of a negative outcome in the dataset.
- * 
- * @var positiveMoveCount
- * @brief 3D array to count occurrences of each move for positive outcomes.
- * 
- * @var negativeMoveCount
- * @brief 3D array to count occurrences of each move for negative outcomes.
- * 
- * @var cM
- * @brief Confusion matrix for evaluating model performance.
- * 
- * @var test_PredictedErrors
- * @brief Counter for the number of errors in the testing dataset predictions.
- * 
- * @var train_PredictedErrors
- * @brief Counter for the number of errors in the training dataset predictions.
- * 
- * @var probabilityErrors
- * @brief Probability of error in the predictions, calculated from the testing dataset.
- * 
- * @var predicted
- * @brief The predicted outcome for the current dataset (1 for positive, 0 for negative).
- * 
- * @var actual
- * @brief The actual outcome for the current dataset (1 for positive, 0 for negative).
+ * @struct NaiveBayesModel
+ * @brief A trained model and how well it predicts its own dataset.
+ *
+ * Filled by `initData()` and read by `getBestPosition()`; nothing of it is kept between
+ * calls, so every engine can own one.
  */
+struct NaiveBayesModel
+{
+    int positive_count;                 /**< Positive outcomes in the training dataset */
+    int negative_count;                 /**< Negative outcomes in the training dataset */
+    double positiveClassProbability;    /**< Probability of a positive outcome in the dataset */
+    double negativeClassProbability;    /**< Probability of a negative outcome in the dataset */
+    int positiveMoveCount[3][3][3];     /**< Occurrences of each move at each cell for positive outcomes */
+    int negativeMoveCount[3][3][3];     /**< Occurrences of each move at each cell for negative outcomes */
+    int cM[4];                          /**< Confusion matrix on the testing dataset: TP, FN, FP, TN */
+    int test_PredictedErrors;           /**< Errors in the testing dataset predictions */
+    int train_PredictedErrors;          /**< Errors in the training dataset predictions */
+    double probabilityErrors;           /**< Probability of error, from the last dataset predicted */
+};
 
 /**  
  * @brief Assigns an index to each move ("x", "o", or "b").
@@ -92,13 +75,14 @@ static int assignMoveIndex(char move);
  *   given the class (positive or negative) with Laplace smoothing applied.
  * 
  * The Laplace smoothing is used to prevent zero probabilities for moves that may not have been observed in the training data.
- * The resulting probabilities are printed for debugging purposes.
+ * The resulting probabilities are logged at `LOG_LEVEL_TRACE` for debugging purposes.
  * 
+ * @param model The model whose counts are used.
  * @param dataset_size The total number of samples in the dataset used for probability calculation.
  * 
- * @see positive_count, negative_count, positiveMoveCount, negativeMoveCount
+ * @see NaiveBayesModel
  */
-static void calculateProbabilities(int dataset_size);
+static void calculateProbabilities(struct NaiveBayesModel *model, int dataset_size);
 
 /**  
  * @brief Resets the training data and associated statistics for a fresh training cycle.
@@ -107,9 +91,11 @@ static void calculateProbabilities(int dataset_size);
  * It clears the outcome counts, resets the move count arrays for each grid position, and reinitializes the confusion matrix.
  * Additionally, it clears the prediction error counters, ensuring that the model starts with a clean state.
  * 
- * @see positive_count, negative_count, positiveMoveCount, negativeMoveCount, cM, test_PredictedErrors, train_PredictedErrors
+ * @param model The model to reset.
+ * 
+ * @see NaiveBayesModel
  */
-static void resetTrainingData();
+static void resetTrainingData(struct NaiveBayesModel *model);
 
 /**  
  * @brief Initializes the training data and model statistics.
@@ -120,9 +106,15 @@ static void resetTrainingData();
  * 
  * If the initial dataset is empty, it attempts to load the data again.
  * 
+ * The dataset files are shared by the process, so callers must not train while another
+ * thread reads or splits them; the model itself is only touched through `model`.
+ * 
+ * @param model The model to train.
+ * @return `SUCCESS`, or the error of `readDataset()`.
+ * 
  * @see resetTrainingData, getTrainingData, calcTrainErrors, calcConfusionMatrix
  */
-int initData();
+int initData(struct NaiveBayesModel *model);
 
 /**  
  * @brief Predicts the outcome of a given Tic Tac Toe board based on previously calculated probabilities.
@@ -134,13 +126,14 @@ int initData();
  * If the calculated probabilities are zero, indicating that the outcome cannot be predicted with the available data,
  * the function returns -1.
  * 
+ * @param model The trained model.
  * @param board The current Tic Tac Toe board whose outcome needs to be predicted.
  * 
  * @return 1 if the predicted outcome is positive (Player 1 wins), 0 if negative (Bot wins), and -1 if the outcome cannot be predicted.
  * 
- * @see positiveClassProbability, negativeClassProbability, positiveMoveCount, negativeMoveCount, assignMoveIndex
+ * @see NaiveBayesModel, assignMoveIndex
  */
-static int predictOutcome(struct Dataset board);
+static int predictOutcome(const struct NaiveBayesModel *model, struct Dataset board);
 
 /**  
  * @brief Calculates the training errors and the probability of error.
@@ -148,9 +141,12 @@ static int predictOutcome(struct Dataset board);
  * This function evaluates the model's performance on the training dataset by comparing predicted outcomes with actual ones. 
  * It updates the count of prediction errors and computes the probability of error based on the number of errors and the size of the training dataset.
  * 
- * @see train_PredictedErrors, probabilityErrors, getTruthValue, predictOutcome
+ * @param model The model to evaluate.
+ * @param data Array the training dataset is read into.
+ * 
+ * @see NaiveBayesModel, getTruthValue, predictOutcome
  */
-static void calcTrainErrors();
+static void calcTrainErrors(struct NaiveBayesModel *model, struct Dataset data[DATA_SIZE]);
 
 /**  
  * @brief Calculates the confusion matrix and error probability for the testing dataset.
@@ -159,9 +155,12 @@ static void calcTrainErrors();
  * It iterates through the testing data, compares actual outcomes with predicted ones, and updates the confusion matrix values. 
  * The number of prediction errors and the probability of error are also computed.
  * 
- * @see cM, test_PredictedErrors, probabilityErrors, getTruthValue, predictOutcome
+ * @param model The model to evaluate.
+ * @param data Array the testing dataset is read into.
+ * 
+ * @see NaiveBayesModel, getTruthValue, predictOutcome
  */
-static void calcConfusionMatrix();
+static void calcConfusionMatrix(struct NaiveBayesModel *model, struct Dataset data[DATA_SIZE]);
 
 /**  
  * @brief Determines the best position for the bot to make a move based on the highest probability.
@@ -171,14 +170,15 @@ static void calcConfusionMatrix();
  * The bot chooses the position with the highest probability of winning, where the move is either 'x' or 'o' 
  * depending on the current player. It returns the best position for the bot to make its move.
  * 
+ * @param model The trained model, which is only read.
  * @param grid The current state of the Tic Tac Toe game board.
  * @param player The current player, either 'x' or 'o'.
  * 
  * @return A struct `Position` representing the row and column of the best move for the bot. If no valid move is found, it returns an error indicator.
  * 
- * @see positive_count, negative_count, positiveMoveCount, negativeMoveCount
+ * @see NaiveBayesModel
  */
-struct Position getBestPosition(int grid[3][3], char player);
+struct Position getBestPosition(const struct NaiveBayesModel *model, int grid[3][3], char player);
 
 /**
  * @brief Returns an integer value representing a truth value based on input.
@@ -196,7 +196,7 @@ struct Position getBestPosition(int grid[3][3], char player);
  * - `0` for "negative".
  * - `-1` for invalid inputs.
  * 
- * @see PRINT_DEBUG
+ * @see LOG_ERROR
  */
 static int getTruthValue(char *str1);
 
@@ -208,12 +208,13 @@ static int getTruthValue(char *str1);
  * 
  * If either the actual or predicted value is ERROR, an error is logged.
  * 
+ * @param model The model whose confusion matrix is updated.
  * @param actual The actual outcome value (1 for positive, 0 for negative).
  * @param predicted The predicted outcome value (1 for positive, 0 for negative).
  * 
- * @see cM, ERROR
+ * @see NaiveBayesModel, ERROR
  */
-static void assignCMValue(int actual, int predicted);
+static void assignCMValue(struct NaiveBayesModel *model, int actual, int predicted);
 
 /**  
  * @brief Debug function to display dataset contents.
@@ -224,7 +225,7 @@ static void assignCMValue(int actual, int predicted);
  * @param data Pointer to the dataset to be printed.
  * @param len The length of the dataset (number of entries).
  * 
- * @see PRINT_DEBUG
+ * @see LOG_DEBUG
  */
 static void debugDataset(struct Dataset *data, int len);
 
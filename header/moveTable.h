@@ -0,0 +1,36 @@
+/**
+ * @file moveTable.h
+ * @author jacktan-jk
+ * @brief Perfect-play move tables generated at build time by `genMoveTable`.
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2024
+ *
+ * 3x3 Tic-Tac-Toe has only 5478 legal positions, so `compile.sh` first builds and runs
+ * `tools/genMoveTable.c`, which searches every position once and writes `src/moveTable.c`.
+ * Each table is indexed by the base-3 board code (`bbBase3()`) and holds the bot's move
+ * as `cell + 1`, where cell is `row * 3 + col`, or `MOVETABLE_NONE` for boards the bot is
+ * never asked to play (finished games, illegal piece counts).
+ */
+
+#ifndef MOVETABLE_H
+#define MOVETABLE_H
+
+#include <macros.h>
+#include <stdint.h>
+
+#define MOVETABLE_SIZE 19683   /**< One slot per base-3 board code (3^9) */
+#define MOVETABLE_NONE 0       /**< Slot value for boards with no stored move */
+
+/**
+ * @var moveTableGodmode
+ * @brief Best move of every position under a full-depth search (`MINIMAX_GODMODE`).
+ *
+ * @var moveTableDepthLimited
+ * @brief Best move of every position under the depth-limited search (`depth > 2` cut-off).
+ */
+extern const uint8_t moveTableGodmode[MOVETABLE_SIZE];
+extern const uint8_t moveTableDepthLimited[MOVETABLE_SIZE];
+
+#endif // MOVETABLE_H
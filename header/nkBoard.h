@@ -0,0 +1,216 @@
+/**
+ * @file nkBoard.h
+ * @author jacktan-jk
+ * @brief Bitboard for N x N boards won by K in a row (N up to 8).
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2024
+ *
+ * Generalises `BitBoard` to the larger boards (4x4 with K=4, 5x5 with K=4, 7x7 with K=5).
+ * Each side is one 64-bit mask where bit `row * n + col` is set when that side occupies
+ * the cell. A side has won when K set bits follow each other in one of the four
+ * directions (right, down, down-right, down-left), which is checked with K-1 shift-and
+ * steps per direction from the cells a line can start on.
+ *
+ * The win kernel takes N and K as arguments but is always inlined. The `switch` in
+ * `nkHasWin()` calls it with literal N and K for every size in `NK_SPECIALISATIONS`, so
+ * the compiler generates a separate, fully unrolled copy of the line checks for each
+ * common size. Other sizes use the same code with runtime loops.
+ */
+
+#ifndef NKBOARD_H
+#define NKBOARD_H
+
+#include <macros.h>
+#include <stdint.h>
+
+#define MAX_N 8                    /**< Largest supported board side (64 cells fit one mask) */
+#define MIN_N 3                    /**< Smallest supported board side */
+#define MAX_CELLS (MAX_N * MAX_N)  /**< Largest number of cells */
+#define MAX_LINES (4 * MAX_CELLS)  /**< Upper bound on the number of K-cell windows */
+#define NK_DIRECTIONS 4            /**< Right, down, down-right, down-left */
+#define MAX_CELL_WINDOWS (NK_DIRECTIONS * MAX_N) /**< Upper bound on the K-cell windows through one cell */
+
+#define NK_WIN_SCORE 30000         /**< Score of a won position, before subtracting the ply (fits a TT entry) */
+
+#define NK_BIT(n, row, col) (1ULL << ((row) * (n) + (col)))   /**< Mask of a single cell */
+#define NK_SIZE(n, k) (((n) << 4) | (k))                    /**< Packs N and K into one switch key */
+
+/**
+ * Board sizes that get their own unrolled kernels: X(N, K).
+ */
+#define NK_SPECIALISATIONS(X) \
+    X(3, 3)                   \
+    X(4, 3)                   \
+    X(4, 4)                   \
+    X(5, 4)                   \
+    X(6, 4)                   \
+    X(7, 5)                   \
+    X(8, 5)
+
+/**
+ * @struct NKBoard
+ * @brief An N x N board won by K in a row, one occupancy mask per side.
+ */
+struct NKBoard
+{
+    uint64_t bot;    /**< Cells occupied by the BOT (X) */
+    uint64_t player; /**< Cells occupied by PLAYER1 (O) */
+    int n;           /**< Board side */
+    int k;           /**< Number in a row needed to win */
+};
+
+/**
+ * @var nkStartMasks
+ * @brief For each N, K and direction, the cells a K-long line in that direction can start on.
+ */
+extern uint64_t nkStartMasks[MAX_N + 1][MAX_N + 1][NK_DIRECTIONS];
+
+/**
+ * @var nkCellWindows
+ * @brief For each N, K and cell, the indexes (into `nkWindows()`) of the windows through the cell.
+ *
+ * @var nkCellWindowCount
+ * @brief For each N, K and cell, the number of entries of `nkCellWindows`.
+ */
+extern uint8_t nkCellWindows[MAX_N + 1][MAX_N + 1][MAX_CELLS][MAX_CELL_WINDOWS];
+extern uint8_t nkCellWindowCount[MAX_N + 1][MAX_N + 1][MAX_CELLS];
+
+/**
+ * @brief Checks that N and K describe a supported board.
+ *
+ * @return `true` if `MIN_N <= n <= MAX_N` and `3 <= k <= n`.
+ */
+bool nkIsValidSize(int n, int k);
+
+/**
+ * @brief Builds an `NKBoard` from a grid of `EMPTY`, `PLAYER1` and `BOT` cells.
+ *
+ * @param grid Cells in `grid[row][col]`, only the top-left n x n part is read.
+ * @param n Board side.
+ * @param k Number in a row needed to win.
+ */
+struct NKBoard nkFromGrid(int grid[MAX_N][MAX_N], int n, int k);
+
+/**
+ * @brief Returns the mask of the first K-in-a-row line completed by a side.
+ *
+ * Used to highlight the winning cells; the search only needs `nkHasWin()`.
+ *
+ * @param mask The occupancy mask of one side.
+ * @param n Board side.
+ * @param k Number in a row needed to win.
+ * @return The K cells of the line, or 0 if the side has no complete line.
+ */
+uint64_t nkWinLine(uint64_t mask, int n, int k);
+
+/**
+ * @brief Returns all K-cell windows of an N x N board (every place a line can be made).
+ *
+ * The windows of every supported size are built before `main()` runs.
+ *
+ * @param n Board side.
+ * @param k Number in a row needed to win.
+ * @param count Set to the number of windows.
+ * @return Pointer to `count` window masks.
+ */
+const uint64_t *nkWindows(int n, int k, int *count);
+
+/**
+ * @brief Returns the empty cells next to (including diagonally) any stone.
+ *
+ * Used by the search to skip cells far away from the play, which cannot be part of a
+ * threat yet.
+ *
+ * @param b The board.
+ * @return The candidate cells, or only the centre cell if the board is empty.
+ */
+uint64_t nkNeighbours(const struct NKBoard *b);
+
+/**
+ * @brief Returns the mask of all cells of an N x N board.
+ */
+static inline uint64_t nkFull(int n)
+{
+    return (n * n == 64) ? ~0ULL : ((1ULL << (n * n)) - 1);
+}
+
+/**
+ * @brief Returns the mask of the empty cells.
+ */
+static inline uint64_t nkEmpty(const struct NKBoard *b)
+{
+    return ~(b->bot | b->player) & nkFull(b->n);
+}
+
+/**
+ * @brief Pops the lowest set bit of a mask and returns its cell index.
+ */
+static inline int nkPopLowest(uint64_t *mask)
+{
+    int idx = __builtin_ctzll(*mask);
+    *mask &= *mask - 1;
+    return idx;
+}
+
+/**
+ * @brief Line check kernel: K set bits in a row in any direction.
+ *
+ * Always inlined so the callers below can pass literal N and K and get the K-1 shift-and
+ * steps of every direction unrolled.
+ */
+static inline __attribute__((always_inline)) bool nkHasWinKernel(uint64_t mask, int n, int k)
+{
+    const int steps[NK_DIRECTIONS] = {1, n, n + 1, n - 1};
+    for (int d = 0; d < NK_DIRECTIONS; d++)
+    {
+        uint64_t run = mask & nkStartMasks[n][k][d];
+        for (int i = 1; i < k; i++)
+        {
+            run &= mask >> (i * steps[d]);
+        }
+        if (run)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Checks if a side's mask contains K in a row.
+ *
+ * Dispatches to the specialised kernel of the board size.
+ *
+ * @param mask The occupancy mask of one side.
+ * @param n Board side.
+ * @param k Number in a row needed to win.
+ */
+static inline bool nkHasWin(uint64_t mask, int n, int k)
+{
+    switch (NK_SIZE(n, k))
+    {
+#define NK_CASE_HAS_WIN(N, K) \
+    case NK_SIZE(N, K):       \
+        return nkHasWinKernel(mask, N, K);
+        NK_SPECIALISATIONS(NK_CASE_HAS_WIN)
+#undef NK_CASE_HAS_WIN
+    default:
+        return nkHasWinKernel(mask, n, k);
+    }
+}
+
+/**
+ * @brief Heuristic evaluation of a board with no winner yet.
+ *
+ * Every K-cell window that holds stones of only one side scores `3^count` for that side,
+ * so open lines close to completion dominate. Positive scores favour the BOT. The result
+ * is clamped to half of `NK_WIN_SCORE` so it never looks like a forced win.
+ *
+ * @param b The board.
+ * @return The score from the BOT's point of view, well inside `NK_WIN_SCORE`.
+ */
+int nkEvaluate(const struct NKBoard *b);
+
+#endif // NKBOARD_H
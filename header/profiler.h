@@ -0,0 +1,138 @@
+/**
+ * @file profiler.h
+ * @author jacktan-jk
+ * @brief Nestable timing spans with per-label statistics, summarised at exit.
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2024
+ *
+ * A span is opened with `PROFILE_BEGIN()` and closed by the next `PROFILE_END()` of the
+ * same thread, or by the end of the block of a `PROFILE_SCOPE()` (one per block). Each thread keeps its own
+ * stack of open spans, so spans nest and threads never share a start time. Spans are
+ * timed with `CLOCK_MONOTONIC` in nanoseconds and added to the statistics of their label:
+ * count, total, min, max and a histogram of quarter powers of two from which the
+ * percentiles are read (within 19%). Each thread writes its own statistics, so closing a
+ * span takes no lock and costs two clock reads. The statistics of a thread that exits stay
+ * in the totals, and their block is reused by the next thread to close a span.
+ *
+ * The first span registers `profileDump()` to print every label to stderr at exit.
+ * Setting `DISABLE_PROFILE` compiles the spans out.
+ * @code
+ * PROFILE_BEGIN("Minimax depth search");
+ * bestMove = searchBestMove(board);
+ * PROFILE_END();
+ *
+ * {
+ *     PROFILE_SCOPE("Bot move"); // ends with the block
+ *     ...
+ * }
+ * @endcode
+ */
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <macros.h>
+#include <stdint.h>
+
+#define PROFILE_MAX_DEPTH 32   /**< Open spans per thread, deeper ones are not timed */
+#define PROFILE_MAX_LABELS 64  /**< Labels per process, further ones are not timed */
+#define PROFILE_BUCKETS 160    /**< Histogram buckets: 4 per power of two up to 2^40 ns */
+
+/**
+ * @struct ProfileStats
+ * @brief Spans of one label, from one thread or summed over all of them.
+ */
+struct ProfileStats
+{
+    uint64_t count;
+    uint64_t totalNs;
+    uint64_t minNs;
+    uint64_t maxNs;
+    uint32_t buckets[PROFILE_BUCKETS]; /**< Spans per duration bucket, see `profileBucket()` */
+};
+
+#if !(DISABLE_PROFILE)
+/** Opens a span; the label is looked up once per call site. */
+#define PROFILE_BEGIN(label)                                                    \
+    do                                                                          \
+    {                                                                           \
+        static int profileId_ = ERROR;                                          \
+        int id_ = __atomic_load_n(&profileId_, __ATOMIC_RELAXED);              \
+        if (id_ == ERROR)                                                       \
+        {                                                                       \
+            id_ = profileLabel(label);                                          \
+            __atomic_store_n(&profileId_, id_, __ATOMIC_RELAXED);              \
+        }                                                                       \
+        profileBegin(id_);                                                      \
+    } while (0)
+/** Closes the innermost open span of the thread. */
+#define PROFILE_END() profileEnd()
+/** Opens a span closed when the enclosing block is left. */
+#define PROFILE_SCOPE(label)                                                    \
+    PROFILE_BEGIN(label);                                                       \
+    __attribute__((cleanup(profileEndScope), unused)) int profileScope_ = 0
+#else
+#define PROFILE_BEGIN(label) ((void)0)
+#define PROFILE_END() ((void)0)
+#define PROFILE_SCOPE(label) ((void)0)
+#endif
+
+/**
+ * @brief Returns the id of a label, registering it on first use. Thread-safe.
+ *
+ * @param label A string that lives as long as the process, usually a literal.
+ * @return The id, or `ERROR` once `PROFILE_MAX_LABELS` labels exist.
+ */
+int profileLabel(const char *label);
+
+/**
+ * @brief Opens a span of a label on the calling thread's stack.
+ *
+ * @param id The label's id from `profileLabel()`, `ERROR` to open an untimed span.
+ */
+void profileBegin(int id);
+
+/**
+ * @brief Closes the innermost open span of the calling thread and records its duration.
+ */
+void profileEnd();
+
+/**
+ * @brief `cleanup` handler of `PROFILE_SCOPE()`.
+ */
+void profileEndScope(int *scope);
+
+/**
+ * @brief Returns the histogram bucket of a duration.
+ *
+ * @param ns Duration in nanoseconds.
+ * @return The bucket: 4 per power of two, so bucket `b` starts at about `2^(b / 4)` ns.
+ */
+int profileBucket(uint64_t ns);
+
+/**
+ * @brief Sums the statistics of a label over every thread that has used it.
+ *
+ * Threads still opening spans make the sums slightly stale, not wrong.
+ *
+ * @param label The label.
+ * @param stats Set to the sums, all zero for an unknown label.
+ * @return `true` if the label exists.
+ */
+bool profileStats(const char *label, struct ProfileStats *stats);
+
+/**
+ * @brief Prints count, total, mean, min, percentiles and max of every label.
+ *
+ * @param file Where to print, stderr at exit.
+ */
+void profileDump(FILE *file);
+
+/**
+ * @brief Clears the statistics of every label, on every thread.
+ */
+void profileReset();
+
+#endif // PROFILER_H
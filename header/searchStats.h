@@ -0,0 +1,140 @@
+/**
+ * @file searchStats.h
+ * @author jacktan-jk
+ * @brief Counters of one bot move: nodes, leaves, cutoffs, table hits, branching and time.
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2024
+ *
+ * `findBestMove()` and `findBestMoveNK()` clear the calling thread's `searchStats` when
+ * they start and keep a copy of it in the search context when they return, read back with
+ * `searchLastStats()` (or `gameSearchStats()` for a libtictactoe game). The searches count
+ * into the thread's own statistics without locking; a parallel search adds its workers'
+ * counts to the calling thread's when it ends.
+ *
+ * A move read from the move table, the game-value database or the best move file counts a
+ * lookup hit and visits no node; each table probed before it without a move counts a miss.
+ * Transposition table probes are counted apart. With `searchStatsLog` set, every bot move
+ * is also appended to it as a line of JSON. Setting `DISABLE_STATS` compiles the
+ * counters out, leaving only the source, move and wall time.
+ * @code
+ * struct Position move = findBestMoveNK(board);
+ * struct SearchStats stats;
+ * searchLastStats(&stats);
+ * searchStatsJson(&stats, stdout); // {"source":"search","n":5,...,"nodes":48211,...}
+ * @endcode
+ */
+
+#ifndef SEARCH_STATS_H
+#define SEARCH_STATS_H
+
+#include <macros.h>
+#include <nkBoard.h>
+#include <stdint.h>
+
+#define STATS_MAX_PLY (MAX_CELLS + 1) /**< Plies below the root counted by the histogram */
+
+// Where the move of a search came from
+#define STATS_SOURCE_NONE 0      /**< No move, or no search made yet */
+#define STATS_SOURCE_MOVETABLE 1 /**< Generated perfect-play move table */
+#define STATS_SOURCE_GAMEDB 2    /**< Retrograde game-value database */
+#define STATS_SOURCE_LOOKUP 3    /**< Best move file */
+#define STATS_SOURCE_SEARCH 4    /**< Minimax or alpha-beta search */
+
+/**
+ * @struct SearchStats
+ * @brief What one bot move cost.
+ */
+struct SearchStats
+{
+    int source;                        /**< `STATS_SOURCE_*` that produced `move` */
+    int n;                             /**< Board size */
+    int k;                             /**< Stones in a row to win */
+    struct Position move;              /**< Move returned, `ERROR` when there was none */
+    int depth;                         /**< Last depth the search completed, 0 when it reports none */
+    uint64_t wallNs;                   /**< Wall time of the whole call, lookups included */
+    uint64_t nodes;                    /**< Positions searched, the root excluded */
+    uint64_t leaves;                   /**< Positions scored without searching a child: won, full, at the depth limit or evaluated */
+    uint64_t cutoffs;                  /**< Alpha-beta cutoffs, transposition table bounds included */
+    uint64_t ttHits;                   /**< Transposition table probes that found the position */
+    uint64_t ttMisses;                 /**< Transposition table probes that did not */
+    uint64_t lookupHits;               /**< Move table, game-value database or best move file probes that gave the move */
+    uint64_t lookupMisses;             /**< Probes of those tables without a move */
+    uint64_t plyNodes[STATS_MAX_PLY];  /**< Nodes per ply below the root, `plyNodes[1]` are the root's children */
+};
+
+#if !(DISABLE_STATS)
+/** Counts a node of a search at a ply below the root. */
+#define STATS_NODE(ply) (searchStats.nodes++, searchStats.plyNodes[ply]++)
+/** Counts an event, one of the `SearchStats` counters. */
+#define STATS_COUNT(counter) (searchStats.counter++)
+/** Counts a leaf and yields its score. */
+#define STATS_LEAF(score) (searchStats.leaves++, (score))
+#else
+#define STATS_NODE(ply) ((void)0)
+#define STATS_COUNT(counter) ((void)0)
+#define STATS_LEAF(score) (score)
+#endif
+
+/**
+ * @var struct SearchStats searchStats
+ * @brief Counters of the search running on this thread, cleared by each bot move.
+ *
+ * @var FILE *searchStatsLog
+ * @brief When set, `searchStatsEnd()` writes every bot move's statistics to it as JSON.
+ */
+extern __thread struct SearchStats searchStats;
+extern FILE *searchStatsLog;
+
+/**
+ * @brief Clears the calling thread's statistics and starts their clock.
+ *
+ * @param n Board size.
+ * @param k Stones in a row to win.
+ */
+void searchStatsBegin(int n, int k);
+
+/**
+ * @brief Stops the clock of the calling thread's statistics and logs them to `searchStatsLog`.
+ *
+ * @param source `STATS_SOURCE_*` the move came from.
+ * @param move The move returned.
+ * @return The finished statistics.
+ */
+const struct SearchStats *searchStatsEnd(int source, struct Position move);
+
+/**
+ * @brief Adds the counters of one search to another, e.g. a worker's to its caller's.
+ *
+ * @param to Statistics added to; its source, board, move, depth and time are kept.
+ * @param from Statistics to add.
+ */
+void searchStatsAdd(struct SearchStats *to, const struct SearchStats *from);
+
+/**
+ * @brief Returns the deepest ply below the root with a node, 0 for no search.
+ */
+int searchStatsDepth(const struct SearchStats *stats);
+
+/**
+ * @brief Returns the effective branching factor of a search.
+ *
+ * The `b` for which a uniform tree `b + b^2 + ... + b^d` as deep as the search has as many
+ * nodes, found by bisection. 0 for no search.
+ */
+double searchStatsBranching(const struct SearchStats *stats);
+
+/**
+ * @brief Writes the statistics as one line of JSON, ended with a newline.
+ *
+ * The keys are `source`, `n`, `k`, `row`, `col`, `wall_us`, `nodes`, `leaves`, `cutoffs`,
+ * `tt_hits`, `tt_misses`, `lookup_hits`, `lookup_misses`, `depth`, `branching` and
+ * `ply_nodes` (an array from ply 1 to `depth`), so a log of moves reads as JSON lines.
+ *
+ * @param stats The statistics.
+ * @param file Where to write.
+ */
+void searchStatsJson(const struct SearchStats *stats, FILE *file);
+
+#endif // SEARCH_STATS_H
@@ -0,0 +1,70 @@
+/**
+ * @file serverProtocol.h
+ * @author jacktan-jk
+ * @brief Line protocol spoken by `tictactoeServer` and its load generator `loadGen`.
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2024
+ *
+ * Every connection plays one game at a time. Requests and replies are single ASCII lines
+ * ending in `\n`, answered in order, so a client may pipeline several requests:
+ * @code
+ * NEW <n> <k> <MM|ML|MC>   ->  OK                       start a game, PLAYER1 (O) to move
+ * MOVE <row> <col>         ->  OK <PLAY|WIN|TIE>        play for the side to move
+ * BOT                      ->  MOVE <row> <col> <PLAY|WIN|TIE>
+ *                                                       search and play the side to move
+ * QUIT                     ->  (connection closed)
+ * @endcode
+ * A request that cannot be served is answered with `ERR <reason>`.
+ *
+ * The server listens on a Unix socket, or on a TCP port of 127.0.0.1 when the address
+ * given on the command line is a number.
+ */
+
+#ifndef SERVER_PROTOCOL_H
+#define SERVER_PROTOCOL_H
+
+#include <macros.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#define SERVER_SOCKET_PATH "/tmp/tictactoe.sock" /**< Default address of the server */
+#define SERVER_LINE_MAX 64                       /**< Longest request or reply, with its newline */
+
+/**
+ * @brief Fills the socket address of a Unix socket path or a localhost TCP port.
+ *
+ * @param where A port number, or the path of a Unix socket.
+ * @param addr Set to the address.
+ * @param len Set to the size of the address.
+ * @return `SUCCESS`, or `BAD_PARAM` for a path that does not fit.
+ */
+static inline int serverAddress(const char *where, struct sockaddr_storage *addr, socklen_t *len)
+{
+    memset(addr, 0, sizeof(*addr));
+    int port = atoi(where);
+    if (port > 0)
+    {
+        struct sockaddr_in *in = (struct sockaddr_in *)addr;
+        in->sin_family = AF_INET;
+        in->sin_port = htons((uint16_t)port);
+        in->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        *len = sizeof(*in);
+        return SUCCESS;
+    }
+
+    struct sockaddr_un *un = (struct sockaddr_un *)addr;
+    if (strlen(where) >= sizeof(un->sun_path))
+    {
+        return BAD_PARAM;
+    }
+    un->sun_family = AF_UNIX;
+    strcpy(un->sun_path, where);
+    *len = sizeof(*un);
+    return SUCCESS;
+}
+
+#endif // SERVER_PROTOCOL_H
@@ -0,0 +1,100 @@
+/**
+ * @file threadPool.h
+ * @author jacktan-jk
+ * @brief Work-stealing thread pool used by the parallel Minimax search.
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2024
+ *
+ * Each worker owns a deque of tasks. A worker pushes and pops the newest tasks at the
+ * bottom of its own deque and, when it runs dry, steals the oldest task from the top of
+ * another worker's deque. Tasks submitted from outside the pool are dealt round-robin
+ * over the workers. The thread waiting for a batch with `poolWait()` runs tasks itself
+ * until the batch is done, so a pool of N workers keeps N+1 threads busy.
+ */
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <macros.h>
+#include <logger.h>
+#include <pthread.h>
+
+#define POOL_MAX_THREADS 64      /**< Largest number of workers */
+#define POOL_DEQUE_SIZE 4096     /**< Tasks each worker deque can hold */
+
+/**
+ * @brief A task: function and argument, run once by any thread of the pool.
+ */
+struct PoolTask
+{
+    void (*fn)(void *arg); /**< Function to run */
+    void *arg;             /**< Argument passed to `fn` */
+};
+
+/**
+ * @struct PoolDeque
+ * @brief Ring buffer of tasks owned by one worker.
+ */
+struct PoolDeque
+{
+    pthread_mutex_t lock;
+    struct PoolTask tasks[POOL_DEQUE_SIZE];
+    unsigned top;    /**< Index of the oldest task, stolen by other workers */
+    unsigned bottom; /**< Index after the newest task, used by the owner */
+};
+
+/**
+ * @struct ThreadPool
+ * @brief Workers, their deques and the count of unfinished tasks.
+ */
+struct ThreadPool
+{
+    int threadCount;                              /**< Number of worker threads */
+    pthread_t threads[POOL_MAX_THREADS];
+    struct PoolDeque deques[POOL_MAX_THREADS];
+    pthread_mutex_t lock;                         /**< Protects `pending` and `shutdown` */
+    pthread_cond_t workAvailable;                 /**< Signalled when tasks are submitted */
+    pthread_cond_t allDone;                       /**< Signalled when `pending` drops to 0 */
+    int pending;                                  /**< Tasks submitted and not yet finished */
+    int queued;                                   /**< Tasks waiting in a deque, workers sleep at 0 */
+    unsigned nextDeque;                           /**< Round-robin target of external submits */
+    bool shutdown;
+};
+
+/**
+ * @brief Returns the number of online CPU cores, at least 1.
+ */
+int poolCoreCount();
+
+/**
+ * @brief Starts a pool of worker threads.
+ *
+ * @param threadCount Number of workers, clamped to `1..POOL_MAX_THREADS`.
+ * @return The pool, or NULL if it cannot be allocated or no thread can be started.
+ */
+struct ThreadPool *poolCreate(int threadCount);
+
+/**
+ * @brief Queues a task. Safe to call from inside a running task.
+ *
+ * A worker of this pool pushes onto its own deque; other threads, workers of another pool
+ * included, deal tasks round-robin. A task that does not fit in a full deque is run
+ * immediately by the caller.
+ */
+void poolSubmit(struct ThreadPool *pool, void (*fn)(void *arg), void *arg);
+
+/**
+ * @brief Runs and waits for every submitted task to finish.
+ *
+ * Must not be called from inside a task.
+ */
+void poolWait(struct ThreadPool *pool);
+
+/**
+ * @brief Stops and joins the workers and frees the pool. Pending tasks are not run.
+ */
+void poolDestroy(struct ThreadPool *pool);
+
+#endif // THREADPOOL_H
@@ -0,0 +1,223 @@
+/**
+ * @file tictactoe.h
+ * @author jacktan-jk
+ * @brief Public API of libtictactoe: engines and games as handles instead of process globals.
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2024
+ *
+ * An `Engine` holds the search settings and the machine learning model, and is shared by
+ * any number of `Game`s. Its settings are read-only once created; its model is read and
+ * retrained under the engine's lock. A `Game` holds one board with its
+ * turn and result, and the `SearchContext` its searches run in: their deadline, cancel
+ * flag, worker threads and MCTS nodes. Different games can therefore be played and
+ * searched at the same time on different threads; one game is used by one thread at a
+ * time, except for `gameCancel()`.
+ *
+ * The transposition table, the generated move table, the best move file and the
+ * game-value databases are shared by every game of the process. For many games at once,
+ * use one search thread per game (`EngineConfig::threads = 1`) and run the games on
+ * a thread each. The GTK app (`main.c`) is one client of this API.
+ * @code
+ * struct Engine *engine = engineCreate(NULL);
+ * struct Game *game = gameCreate(engine, 3, 3);
+ * int state = gamePlay(game, 1, 1);                  // PLAYER1 (O) moves first
+ * struct Position move = gameBotMove(game, MODE_MM); // reply of the side to move
+ * state = gamePlay(game, move.row, move.col);
+ * gameDestroy(game);
+ * engineDestroy(engine);
+ * @endcode
+ */
+
+#ifndef TICTACTOE_H
+#define TICTACTOE_H
+
+#include <macros.h>
+#include <nkBoard.h>
+#include <searchStats.h>
+
+/**
+ * @struct EngineConfig
+ * @brief Settings of an engine, copied by `engineCreate()`.
+ */
+struct EngineConfig
+{
+    int searchMode;   /**< `SEARCH_MINIMAX` or `SEARCH_ALPHABETA` on 3x3 boards */
+    int depthLimit;   /**< Deepest 3x3 ply, or `NO_DEPTH_LIMIT` */
+    int timeBudget;   /**< Milliseconds per move on larger boards and in MCTS, 0 for a fixed depth */
+    int threads;      /**< Threads per search, 0 for one per core */
+    int mctsPlayouts; /**< Playouts per MCTS move, 0 to use `timeBudget` */
+    bool useModel;    /**< Whether to train the naive Bayes model for `MODE_ML` */
+};
+
+struct Engine;
+struct Game;
+
+/**
+ * @brief Fills a configuration with the defaults of `macros.h`, and the model enabled.
+ *
+ * @param config The configuration to fill.
+ */
+void engineDefaultConfig(struct EngineConfig *config);
+
+/**
+ * @brief Creates an engine and maps the shared lookup files.
+ *
+ * When `useModel` is set, the naive Bayes model is trained from the dataset; if that
+ * fails the engine is still created, without `MODE_ML` (`engineHasModel()`).
+ *
+ * @param config Settings to use, or NULL for `engineDefaultConfig()`.
+ * @return The engine, or NULL if it cannot be allocated.
+ */
+struct Engine *engineCreate(const struct EngineConfig *config);
+
+/**
+ * @brief Checks if the engine can play `MODE_ML`.
+ */
+bool engineHasModel(struct Engine *engine);
+
+/**
+ * @brief Reshuffles the dataset and retrains the model.
+ *
+ * The new model is trained aside and replaces the old one at once, so the engine's games
+ * may keep searching in `MODE_ML` meanwhile. If training fails the engine has no model.
+ *
+ * @return `SUCCESS`, or the error of `readDataset()` or `initData()`.
+ */
+int engineRetrainModel(struct Engine *engine);
+
+/**
+ * @brief Frees an engine once all its games are destroyed.
+ */
+void engineDestroy(struct Engine *engine);
+
+/**
+ * @brief Starts a game on an empty N x N board won by K in a row, `PLAYER1` to move.
+ *
+ * @param engine The engine whose settings the game's searches use.
+ * @param n Board side.
+ * @param k Number in a row needed to win.
+ * @return The game, or NULL for an unsupported size (`nkIsValidSize()`) or no memory.
+ */
+struct Game *gameCreate(struct Engine *engine, int n, int k);
+
+/**
+ * @brief Changes the search settings of one game, the engine's stay as they are.
+ *
+ * `EngineConfig::useModel` is ignored, the model belongs to the engine. Must not be
+ * called while the game is searching.
+ *
+ * @param game The game.
+ * @param config The settings to search with from now on.
+ */
+void gameConfigure(struct Game *game, const struct EngineConfig *config);
+
+/**
+ * @brief Clears the board of a game, `PLAYER1` to move. The search threads are kept.
+ */
+void gameReset(struct Game *game);
+
+/**
+ * @brief Stops the worker threads of a game and frees it.
+ */
+void gameDestroy(struct Game *game);
+
+/**
+ * @brief Plays a move for the side to move.
+ *
+ * @param game The game.
+ * @param row Row of the cell.
+ * @param col Column of the cell.
+ * @return `WIN` if the move wins, `TIE` if it fills the board, `PLAY` otherwise, or
+ *         `BAD_PARAM` if the game is over or the cell is taken or off the board.
+ */
+int gamePlay(struct Game *game, int row, int col);
+
+/**
+ * @brief Searches the move of the side to move, without playing it.
+ *
+ * `PLAYER1`'s moves are found by searching the board with the two sides swapped.
+ *
+ * @param game The game.
+ * @param mode `MODE_MM`, `MODE_MC`, or `MODE_ML` on 3x3 boards.
+ * @return The move, or `{ERROR, ERROR}` if the game is over, the mode cannot play or
+ *         the search was cancelled.
+ *
+ * @see gameSearch
+ */
+struct Position gameBotMove(struct Game *game, int mode);
+
+/**
+ * @brief Searches the BOT's move on any board, with the game's settings and threads.
+ *
+ * The game's own board is not read, so another thread may keep playing on it; this is
+ * how the GUI ponders replies the human has not played yet.
+ *
+ * @param game The game whose search context is used.
+ * @param b The board, BOT to move.
+ * @param mode `MODE_MM`, `MODE_MC`, or `MODE_ML` on 3x3 boards.
+ * @return The move, or `{ERROR, ERROR}` if there is none or the search was cancelled.
+ */
+struct Position gameSearch(struct Game *game, struct NKBoard b, int mode);
+
+/**
+ * @brief Cancels, or allows again, the game's searches. Safe from any thread.
+ *
+ * A running search stops early and its move must be thrown away. The flag stays set,
+ * making later searches return at once, until the searching thread clears it.
+ *
+ * @param game The game.
+ * @param isCancelled `true` to cancel, `false` before the next search.
+ */
+void gameCancel(struct Game *game, bool isCancelled);
+
+/**
+ * @brief Ends, or allows again, the game's timed searches early. Safe from any thread.
+ *
+ * Unlike `gameCancel()` the search still returns a move: a timed Minimax search keeps the
+ * last depth it completed and MCTS its most visited move. Minimax searches to a fixed
+ * depth run to the end. The flag stays set until the searching thread clears it.
+ *
+ * @param game The game.
+ * @param isStopped `true` to stop, `false` before the next search.
+ */
+void gameStop(struct Game *game, bool isStopped);
+
+/**
+ * @brief Checks if the game's searches are cancelled.
+ */
+bool gameIsCancelled(const struct Game *game);
+
+/**
+ * @brief Copies the statistics of the game's last Minimax (`MODE_MM`) move.
+ *
+ * Nodes, leaves, cutoffs, table hits, plies and time of the search or table the move came
+ * from, see `SearchStats`; `searchStatsJson()` writes them as a line of JSON.
+ *
+ * @param game The game, not searching on another thread.
+ * @param stats Set to the statistics, all zero before the first move.
+ */
+void gameSearchStats(const struct Game *game, struct SearchStats *stats);
+
+/**
+ * @brief Returns the stones, N and K of the game's board.
+ */
+struct NKBoard gameBoard(const struct Game *game);
+
+/**
+ * @brief Returns the side to move, `PLAYER1` or `BOT`.
+ */
+int gameTurn(const struct Game *game);
+
+/**
+ * @brief Returns the side with K in a row, `PLAYER1` or `BOT`, or `EMPTY`.
+ */
+int gameWinner(const struct Game *game);
+
+/**
+ * @brief Returns the cells of the winner's K in a row, 0 if nobody has won.
+ */
+uint64_t gameWinLine(const struct Game *game);
+
+#endif // TICTACTOE_H
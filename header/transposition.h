@@ -0,0 +1,119 @@
+/**
+ * @file transposition.h
+ * @author jacktan-jk
+ * @brief Symmetry-aware transposition table for the bitboard Minimax engine.
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2024
+ *
+ * The same position is reached through many move orders, and each of the 8 rotations and
+ * reflections of a board (the D4 symmetry group) has the same game value. Before a node is
+ * searched its board is reduced to a canonical form (the smallest packed board over the 8
+ * symmetries), hashed with Zobrist keys and looked up in a fixed-size table. Each entry
+ * keeps the score and whether it is exact or only a lower/upper bound from an alpha-beta
+ * cutoff.
+ *
+ * N x N boards (`NKBoard`) share the table but are hashed without symmetry reduction; their
+ * keys also depend on N and K so different board sizes never collide.
+ *
+ * Probes and stores are safe to call from several search threads at once without locking.
+ */
+
+#ifndef TRANSPOSITION_H
+#define TRANSPOSITION_H
+
+#include <macros.h>
+#include <bitboard.h>
+#include <nkBoard.h>
+
+#define TT_BITS 16                 /**< log2 of the number of table entries */
+#define TT_SIZE (1 << TT_BITS)     /**< Number of table entries */
+#define BB_SYMMETRIES 8            /**< Rotations and reflections of the square (D4) */
+
+// Bound types stored with a score
+#define TT_EXACT 0                 /**< Score is the exact value of the position */
+#define TT_LOWER 1                 /**< Score is a lower bound (search failed high) */
+#define TT_UPPER 2                 /**< Score is an upper bound (search failed low) */
+
+/**
+ * @struct TTEntry
+ * @brief A transposition table entry as returned by `ttProbe()`.
+ */
+struct TTEntry
+{
+    uint64_t key;   /**< Full Zobrist key of the canonical position */
+    int16_t score;  /**< Stored score, from the bot's point of view */
+    uint8_t bound;  /**< `TT_EXACT`, `TT_LOWER` or `TT_UPPER` */
+    uint8_t depth;  /**< Plies left below the position when it was searched, `TT_FULL_DEPTH` for a full-depth score */
+};
+
+/**
+ * @brief Maps a board to its canonical representative under the 8 board symmetries.
+ *
+ * Every rotation and reflection of the board is packed as `bot | player << 9` and the
+ * smallest one is returned, so all 8 symmetric boards share one representative.
+ *
+ * @param b The board to canonicalise.
+ * @return The canonical board.
+ */
+struct BitBoard bbCanonical(struct BitBoard b);
+
+/**
+ * @brief Computes the Zobrist key of a position after canonicalisation.
+ *
+ * @param b The board.
+ * @param isMax `true` if the bot is to move; the side to move is part of the key.
+ * @return A non-zero 64-bit key.
+ *
+ * @see bbCanonical
+ */
+uint64_t ttKey(struct BitBoard b, bool isMax);
+
+/**
+ * @brief Computes the Zobrist key of an N x N position.
+ *
+ * The search updates the key incrementally with `ttMoveKeyNK()` instead of calling this
+ * at every node.
+ *
+ * @param b The board.
+ * @param isMax `true` if the bot is to move.
+ * @return A 64-bit key.
+ */
+uint64_t ttKeyNK(const struct NKBoard *b, bool isMax);
+
+/**
+ * @brief Returns the value to XOR into an N x N key when a stone is placed.
+ *
+ * @param idx Cell index of the move, `row * n + col`.
+ * @param isBot `true` if the bot made the move.
+ * @return The key of the stone combined with the change of side to move.
+ */
+uint64_t ttMoveKeyNK(int idx, bool isBot);
+
+/**
+ * @brief Looks up a position in the transposition table.
+ *
+ * @param key Key returned by `ttKey()`.
+ * @param depth Plies the caller searches below the position.
+ * @param entry Filled with the stored entry on a hit.
+ * @return `true` if the slot holds this key searched as deep.
+ */
+bool ttProbe(uint64_t key, int depth, struct TTEntry *entry);
+
+/**
+ * @brief Stores a search result, replacing whatever occupied the slot.
+ *
+ * @param key Key returned by `ttKey()`.
+ * @param depth Plies searched below the position.
+ * @param score The score returned by the search.
+ * @param bound `TT_EXACT`, `TT_LOWER` or `TT_UPPER`.
+ */
+void ttStore(uint64_t key, int depth, int score, int bound);
+
+/**
+ * @brief Empties the transposition table.
+ */
+void ttClear();
+
+#endif // TRANSPOSITION_H
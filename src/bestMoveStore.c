@@ -0,0 +1,559 @@
+#include <bestMoveStore.h>
+#include <minimax.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <pthread.h>
+
+#define BESTMOV_FILE_SIZE (sizeof(struct BestMoveHeader) + BESTMOV_NAMESPACES * (sizeof(uint64_t) + BB_CODES)) /**< Size of the file, and of its image */
+#define BESTMOV_SHM_SIZE (sizeof(struct BestMoveShared) + BESTMOV_FILE_SIZE) /**< Control block, then the file image */
+
+static struct BestMoveShared *shared = NULL; /**< Start of the segment, NULL when not mapped */
+static uint8_t *mappedFile = NULL;  /**< Image of the file in the segment */
+static uint64_t *namespaceKeys = NULL; /**< `BESTMOV_NAMESPACES` keys following the header */
+static uint8_t *moveSlots = NULL;   /**< `BB_CODES` move slots per namespace following the keys */
+static pthread_mutex_t loadLock = PTHREAD_MUTEX_INITIALIZER; /**< Serialises the first mapping of concurrent games */
+static bool isFullWarned = false;   /**< The full namespaces were reported, every lookup would again */
+
+static char storePath[PATH_MAX];    /**< The file snapshots are written to */
+static char shmName[NAME_MAX];
+static bool isClosing = false;
+static pthread_t flushThread;
+static bool hasFlushThread = false;
+static pthread_mutex_t storeLock = PTHREAD_MUTEX_INITIALIZER; /**< Guards the flush thread and the snapshots */
+static pthread_cond_t flushCond = PTHREAD_COND_INITIALIZER;
+
+static bool isValidHeader(const struct BestMoveHeader *header)
+{
+    return memcmp(header->magic, BESTMOV_MAGIC, sizeof(header->magic)) == 0 &&
+           header->version == BESTMOV_VERSION &&
+           header->slotCount == BB_CODES &&
+           header->namespaceCount == BESTMOV_NAMESPACES;
+}
+
+static int countStoredMoves()
+{
+    int count = 0;
+    for (int code = 0; code < BESTMOV_NAMESPACES * BB_CODES; code++)
+    {
+        count += (moveSlots[code] != MOVETABLE_NONE);
+    }
+    return count;
+}
+
+// Slots of the key's namespace, claiming a free one if asked; NULL if there is none
+static uint8_t *namespaceSlots(uint64_t key, bool isClaimed)
+{
+    if (moveSlots == NULL)
+    {
+        return NULL;
+    }
+    for (int ns = 0; ns < BESTMOV_NAMESPACES; ns++)
+    {
+        uint64_t owner = __atomic_load_n(&namespaceKeys[ns], __ATOMIC_ACQUIRE);
+        if (owner == 0 && isClaimed)
+        {
+            // another process may claim it first, for these settings or others
+            __atomic_compare_exchange_n(&namespaceKeys[ns], &owner, key, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+            owner = (owner == 0) ? key : owner;
+        }
+        if (owner == key)
+        {
+            return moveSlots + (size_t)ns * BB_CODES;
+        }
+        if (owner == 0)
+        {
+            return NULL;
+        }
+    }
+    if (!__atomic_exchange_n(&isFullWarned, true, __ATOMIC_RELAXED))
+    {
+        LOG_WARN("All %d best move namespaces are taken\n", BESTMOV_NAMESPACES);
+    }
+    return NULL;
+}
+
+uint64_t bestMoveDefaultKey()
+{
+    return bestMoveKey(MINIMAX_ENGINE_VERSION, (MINIMAX_ALPHABETA) ? SEARCH_ALPHABETA : SEARCH_MINIMAX,
+                       (MINIMAX_GODMODE) ? NO_DEPTH_LIMIT : MINIMAX_DEPTH_LIMIT, 3, 3);
+}
+
+// One segment per file: FNV-1a of its absolute path
+static void makeShmName(const char *path)
+{
+    char absPath[PATH_MAX];
+    const char *key = (realpath(path, absPath) != NULL) ? absPath : path;
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    for (const char *c = key; *c != '\0'; c++)
+    {
+        hash = (hash ^ (uint8_t)*c) * 0x100000001B3ULL;
+    }
+    snprintf(shmName, sizeof(shmName), BESTMOV_SHM_PREFIX "%d-%016llx", BESTMOV_VERSION, (unsigned long long)hash);
+}
+
+// Writes the table to a new file renamed over the old one
+static void writeSnapshot()
+{
+    char tmpPath[PATH_MAX + 16];
+    snprintf(tmpPath, sizeof(tmpPath), "%s.%d.tmp", storePath, (int)getpid());
+
+    int fd = open(tmpPath, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    bool isWritten = fd >= 0 && write(fd, mappedFile, BESTMOV_FILE_SIZE) == (ssize_t)BESTMOV_FILE_SIZE &&
+                     fsync(fd) == 0;
+    if (fd >= 0)
+    {
+        close(fd);
+    }
+    if (!isWritten || rename(tmpPath, storePath) != 0)
+    {
+        LOG_ERROR("Error writing best move snapshot. -> %s\n", storePath);
+        unlink(tmpPath);
+    }
+}
+
+static bool isAlive(int pid)
+{
+    return kill(pid, 0) == 0 || errno != ESRCH;
+}
+
+// Whether this process writes the snapshots, taking the role over from a process that died
+static bool claimPersister()
+{
+    int self = (int)getpid();
+    int owner = __atomic_load_n(&shared->persister, __ATOMIC_ACQUIRE);
+    if (owner == self)
+    {
+        return true;
+    }
+    if (owner != 0 && isAlive(owner))
+    {
+        return false;
+    }
+    return __atomic_compare_exchange_n(&shared->persister, &owner, self, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+}
+
+// Snapshots the segment if this process is the persister and it changed; storeLock held
+static void flushShared()
+{
+    uint64_t generation = __atomic_load_n(&shared->generation, __ATOMIC_ACQUIRE);
+    if (generation != __atomic_load_n(&shared->savedGeneration, __ATOMIC_ACQUIRE) && claimPersister())
+    {
+        writeSnapshot();
+        __atomic_store_n(&shared->savedGeneration, generation, __ATOMIC_RELEASE);
+    }
+}
+
+// Polls the generation, as the moves stored by other processes signal nobody here
+static void *flushMain(void *arg)
+{
+    (void)arg;
+    int dirtyMs = 0; // how long the segment has been seen ahead of the file
+    pthread_mutex_lock(&storeLock);
+    while (!isClosing)
+    {
+        struct timespec wake;
+        clock_gettime(CLOCK_REALTIME, &wake);
+        wake.tv_nsec += BESTMOV_POLL_MS * 1000000L;
+        if (wake.tv_nsec >= 1000000000L)
+        {
+            wake.tv_sec++;
+            wake.tv_nsec -= 1000000000L;
+        }
+        pthread_cond_timedwait(&flushCond, &storeLock, &wake);
+
+        uint64_t unsaved = __atomic_load_n(&shared->generation, __ATOMIC_ACQUIRE) -
+                           __atomic_load_n(&shared->savedGeneration, __ATOMIC_ACQUIRE);
+        dirtyMs = (unsaved == 0) ? 0 : dirtyMs + BESTMOV_POLL_MS;
+        if (unsaved >= BESTMOV_FLUSH_BATCH || dirtyMs >= BESTMOV_FLUSH_MS)
+        {
+            flushShared();
+            dirtyMs = 0;
+        }
+    }
+    pthread_mutex_unlock(&storeLock);
+    return NULL;
+}
+
+// Fills a new segment from the file, or with an empty table
+static void loadSegment(int fd)
+{
+    struct BestMoveHeader *header = (struct BestMoveHeader *)mappedFile;
+    struct stat st;
+    bool isLoaded = fstat(fd, &st) == 0 && st.st_size == (off_t)BESTMOV_FILE_SIZE &&
+                    pread(fd, mappedFile, BESTMOV_FILE_SIZE, 0) == (ssize_t)BESTMOV_FILE_SIZE &&
+                    isValidHeader(header);
+    if (!isLoaded)
+    {
+        LOG_WARN("%s <- Not a best move file. Creating new table.\n", storePath);
+        memset(mappedFile, 0, BESTMOV_FILE_SIZE);
+        memcpy(header->magic, BESTMOV_MAGIC, sizeof(header->magic));
+        header->version = BESTMOV_VERSION;
+        header->slotCount = BB_CODES;
+        header->namespaceCount = BESTMOV_NAMESPACES;
+        shared->generation = 1; // not on disk yet
+    }
+    shared->storedMoves = isLoaded ? countStoredMoves() : 0;
+    __atomic_store_n(&shared->isReady, 1, __ATOMIC_RELEASE);
+}
+
+// Takes the lock serialising the opening and closing of the file's segment; ERROR if it cannot
+static int lockStore(const char *path)
+{
+    char lockPath[PATH_MAX + sizeof(BESTMOV_LOCK_SUFFIX)];
+    snprintf(lockPath, sizeof(lockPath), "%s" BESTMOV_LOCK_SUFFIX, path);
+    int lockFd = open(lockPath, O_RDWR | O_CREAT, 0644);
+    if (lockFd >= 0 && flock(lockFd, LOCK_EX) != 0)
+    {
+        close(lockFd);
+        lockFd = ERROR;
+    }
+    return (lockFd >= 0) ? lockFd : ERROR;
+}
+
+static void mapSegment(void *map)
+{
+    shared = map;
+    mappedFile = (map != NULL) ? (uint8_t *)map + sizeof(struct BestMoveShared) : NULL;
+    namespaceKeys = (map != NULL) ? (uint64_t *)(mappedFile + sizeof(struct BestMoveHeader)) : NULL;
+    moveSlots = (map != NULL) ? (uint8_t *)(namespaceKeys + BESTMOV_NAMESPACES) : NULL;
+}
+
+// Forgets the users that died without closing and returns how many are left; file lock held
+static int countUsers()
+{
+    int count = 0;
+    for (int u = 0; u < BESTMOV_MAX_USERS; u++)
+    {
+        if (shared->users[u] != 0 && !isAlive(shared->users[u]))
+        {
+            shared->users[u] = 0;
+        }
+        count += (shared->users[u] != 0);
+    }
+    return count;
+}
+
+// Whether an existing segment was left behind by processes that died, saving its moves if
+// it was loaded; file lock held, so a segment still being created is never seen here
+static bool isStaleSegment(int shmFd)
+{
+    struct stat st;
+    if (fstat(shmFd, &st) != 0 || st.st_size < (off_t)BESTMOV_SHM_SIZE)
+    {
+        LOG_WARN("Shared best move table was never sized by its creator. -> %s\n", shmName);
+        return true;
+    }
+
+    void *map = mmap(NULL, BESTMOV_SHM_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, shmFd, 0);
+    if (map == MAP_FAILED)
+    {
+        return false; // mapping it again below reports the error
+    }
+    mapSegment(map);
+    bool isStale = __atomic_load_n(&shared->isReady, __ATOMIC_ACQUIRE) == 0 || countUsers() == 0;
+    if (isStale && shared->isReady)
+    {
+        LOG_WARN("Every process using the shared best move table died. Saving it. -> %s\n", shmName);
+        pthread_mutex_lock(&storeLock);
+        flushShared();
+        pthread_mutex_unlock(&storeLock);
+    }
+    else if (isStale)
+    {
+        LOG_WARN("Shared best move table was never loaded by its creator. -> %s\n", shmName);
+    }
+    munmap(map, BESTMOV_SHM_SIZE);
+    mapSegment(NULL);
+    return isStale;
+}
+
+int openBestMoveFile(const char *path)
+{
+    if (shared != NULL)
+    {
+        return shared->storedMoves;
+    }
+
+    int fd = open(path, O_RDWR | O_CREAT, 0644);
+    int lockFd = (fd >= 0 && strlen(path) < sizeof(storePath)) ? lockStore(path) : ERROR;
+    if (lockFd < 0)
+    {
+        LOG_ERROR("Error opening best move file. -> %s\n", path);
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+        return ERROR;
+    }
+    strcpy(storePath, path);
+    makeShmName(path);
+
+    // the first process creates and loads the segment, the others attach to it; a segment
+    // left behind by processes that died is removed and created again from the file
+    bool isCreator = true;
+    int shmFd = shm_open(shmName, O_RDWR | O_CREAT | O_EXCL, 0644);
+    if (shmFd < 0 && errno == EEXIST)
+    {
+        isCreator = false;
+        shmFd = shm_open(shmName, O_RDWR, 0);
+        if (shmFd >= 0 && isStaleSegment(shmFd))
+        {
+            close(shmFd);
+            shm_unlink(shmName);
+            isCreator = true;
+            shmFd = shm_open(shmName, O_RDWR | O_CREAT | O_EXCL, 0644);
+            close(fd);
+            fd = open(path, O_RDWR | O_CREAT, 0644); // saving it renamed a new file over the old one
+        }
+    }
+    if (shmFd < 0 || fd < 0 || (isCreator && ftruncate(shmFd, BESTMOV_SHM_SIZE) != 0))
+    {
+        LOG_ERROR("Error creating shared best move table. -> %s\n", shmName);
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+        close(lockFd);
+        if (shmFd >= 0)
+        {
+            close(shmFd);
+        }
+        return ERROR;
+    }
+
+    void *map = mmap(NULL, BESTMOV_SHM_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, shmFd, 0);
+    close(shmFd); // the mapping keeps the segment referenced
+    if (map == MAP_FAILED)
+    {
+        LOG_ERROR("Error mapping shared best move table. -> %s\n", shmName);
+        close(fd);
+        close(lockFd);
+        return ERROR;
+    }
+
+    mapSegment(map);
+    if (isCreator)
+    {
+        loadSegment(fd);
+    }
+    close(fd);
+
+    int user = 0;
+    countUsers();
+    while (user < BESTMOV_MAX_USERS && shared->users[user] != 0)
+    {
+        user++;
+    }
+    if (user == BESTMOV_MAX_USERS)
+    {
+        LOG_ERROR("Shared best move table has %d users already. -> %s\n", BESTMOV_MAX_USERS, shmName);
+        munmap(map, BESTMOV_SHM_SIZE);
+        mapSegment(NULL);
+        close(lockFd);
+        return ERROR;
+    }
+    shared->users[user] = (int)getpid();
+    close(lockFd);
+    isClosing = false;
+
+    static bool isExitFlushed = false;
+    if (!isExitFlushed)
+    {
+        isExitFlushed = atexit(closeBoardStates) == 0;
+    }
+    hasFlushThread = pthread_create(&flushThread, NULL, flushMain, NULL) == 0;
+    return shared->storedMoves;
+}
+
+int loadBoardStates()
+{
+    pthread_mutex_lock(&loadLock);
+    if (shared != NULL)
+    {
+        pthread_mutex_unlock(&loadLock);
+        return shared->storedMoves;
+    }
+
+    int count = openBestMoveFile(FILE_BESTMOV);
+    if (count == ERROR)
+    {
+        pthread_mutex_unlock(&loadLock);
+        return ERROR; // already reported by openBestMoveFile()
+    }
+    if (count == 0 && access(FILE_BESTMOV_TXT, R_OK) == 0)
+    {
+        LOG_INFO("Importing legacy lookup file %s\n", FILE_BESTMOV_TXT);
+        importBestMoveText(FILE_BESTMOV_TXT, bestMoveDefaultKey());
+        count = shared->storedMoves;
+    }
+    LOG_INFO("Mapped %d positions from %s\n", count, FILE_BESTMOV);
+    pthread_mutex_unlock(&loadLock);
+    return count;
+}
+
+void closeBoardStates()
+{
+    if (shared == NULL)
+    {
+        return;
+    }
+
+    pthread_mutex_lock(&storeLock);
+    isClosing = true;
+    pthread_cond_signal(&flushCond);
+    pthread_mutex_unlock(&storeLock);
+    if (hasFlushThread)
+    {
+        pthread_join(flushThread, NULL);
+        hasFlushThread = false;
+    }
+
+    // no process may attach while the last one removes the segment
+    int lockFd = lockStore(storePath);
+    pthread_mutex_lock(&storeLock);
+    int self = (int)getpid();
+    for (int u = 0; u < BESTMOV_MAX_USERS; u++)
+    {
+        if (shared->users[u] == self)
+        {
+            shared->users[u] = 0;
+        }
+    }
+    bool isLast = lockFd >= 0 && countUsers() == 0;
+    if (isLast)
+    {
+        claimPersister(); // nobody is left to save the last inserts
+    }
+    flushShared();
+
+    // hand the snapshots over to a process still running
+    __atomic_compare_exchange_n(&shared->persister, &self, 0, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+    if (isLast)
+    {
+        shm_unlink(shmName); // the next process loads the file again
+    }
+    munmap(shared, BESTMOV_SHM_SIZE);
+    mapSegment(NULL);
+    pthread_mutex_unlock(&storeLock);
+    if (lockFd >= 0)
+    {
+        close(lockFd);
+    }
+}
+
+bool checkAndUpdateBestMove(uint64_t key, int board[3][3], struct Position *bestMove)
+{
+    uint8_t *slots = namespaceSlots(key, false);
+    if (slots == NULL)
+    {
+        LOG_DEBUG("No lookup table for these settings\n");
+        return false;
+    }
+
+    int slot = __atomic_load_n(&slots[bbBase3(bbFromArray(board))], __ATOMIC_RELAXED);
+    if (slot == MOVETABLE_NONE)
+    {
+        LOG_DEBUG("Position not found in lookup table\n");
+        return false;
+    }
+
+    bestMove->row = BB_ROW(slot - 1);
+    bestMove->col = BB_COL(slot - 1);
+    LOG_DEBUG("Found position in lookup table\n");
+    LOG_DEBUG("Best Move = R:%d C:%d\n", bestMove->row, bestMove->col);
+    return true;
+}
+
+void writeBestMoveToFile(uint64_t key, int board[3][3], struct Position bestMove)
+{
+    uint8_t *slots = (bestMove.row < 0 || bestMove.row > 2 || bestMove.col < 0 || bestMove.col > 2)
+                         ? NULL
+                         : namespaceSlots(key, true);
+    if (slots == NULL)
+    {
+        return;
+    }
+
+    // first writer wins, in any process; a solved board keeps its move
+    uint8_t expected = MOVETABLE_NONE;
+    uint8_t move = (uint8_t)(bestMove.row * 3 + bestMove.col + 1);
+    if (!__atomic_compare_exchange_n(&slots[bbBase3(bbFromArray(board))], &expected, move, false,
+                                     __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+    {
+        return;
+    }
+
+    __atomic_add_fetch(&shared->storedMoves, 1, __ATOMIC_RELAXED);
+    uint64_t generation = __atomic_add_fetch(&shared->generation, 1, __ATOMIC_RELEASE);
+    if (generation - __atomic_load_n(&shared->savedGeneration, __ATOMIC_RELAXED) >= BESTMOV_FLUSH_BATCH)
+    {
+        pthread_cond_signal(&flushCond);
+    }
+    LOG_DEBUG("New best move stored: Row = %d, Col = %d\n", bestMove.row, bestMove.col);
+}
+
+int importBestMoveText(const char *path, uint64_t key)
+{
+    FILE *file = fopen(path, "r");
+    if (file == NULL)
+    {
+        LOG_ERROR("Error opening file for reading. -> %s\n", path);
+        return BAD_PARAM;
+    }
+
+    int count = 0;
+    char line[100];
+    while (fgets(line, sizeof(line), file) != NULL)
+    {
+        int board[3][3];
+        struct Position bestMove;
+
+        // Parse the line
+        char *token = strtok(line, ",");
+        int index = 0;
+
+        // Read the board condition
+        while (token != NULL && index < 9)
+        {
+            if (strcmp(token, "x") == 0)
+            {
+                board[index / 3][index % 3] = BOT;
+            }
+            else if (strcmp(token, "o") == 0)
+            {
+                board[index / 3][index % 3] = PLAYER1;
+            }
+            else
+            {
+                board[index / 3][index % 3] = EMPTY;
+            }
+            token = strtok(NULL, ",");
+            index++;
+        }
+
+        // Read the best move, skipping partial lines
+        if (index < 9 || token == NULL)
+        {
+            continue;
+        }
+        bestMove.row = atoi(token);
+        token = strtok(NULL, ",");
+        if (token == NULL)
+        {
+            continue;
+        }
+        bestMove.col = atoi(token);
+
+        writeBestMoveToFile(key, board, bestMove);
+        count++;
+    }
+
+    fclose(file);
+    return count;
+}
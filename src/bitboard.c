@@ -0,0 +1,45 @@
+#include <bitboard.h>
+
+const uint16_t bbWinMasks[BB_LINES] = {
+    0x007, 0x038, 0x1C0, // rows
+    0x049, 0x092, 0x124, // columns
+    0x111, 0x054         // diagonals
+};
+
+uint16_t bbWinTable[BB_FULL + 1];
+
+__attribute__((constructor)) static void bbInitWinTable()
+{
+    for (int mask = 0; mask <= BB_FULL; mask++)
+    {
+        bbWinTable[mask] = 0;
+        for (int i = 0; i < BB_LINES; i++)
+        {
+            if ((mask & bbWinMasks[i]) == bbWinMasks[i])
+            {
+                bbWinTable[mask] = bbWinMasks[i];
+                break;
+            }
+        }
+    }
+}
+
+struct BitBoard bbFromArray(int board[3][3])
+{
+    struct BitBoard b = {0, 0};
+    for (int i = 0; i < 3; i++)
+    {
+        for (int j = 0; j < 3; j++)
+        {
+            if (board[i][j] == BOT)
+            {
+                b.bot |= BB_BIT(i, j);
+            }
+            else if (board[i][j] == PLAYER1)
+            {
+                b.player |= BB_BIT(i, j);
+            }
+        }
+    }
+    return b;
+}
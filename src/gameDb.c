@@ -0,0 +1,159 @@
+#include <gameDb.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+static const uint8_t *dbEntries[GAMEDB_MAX_N + 1][GAMEDB_MAX_N + 1]; /**< Mapped entries per N and K */
+static bool dbTried[GAMEDB_MAX_N + 1][GAMEDB_MAX_N + 1];             /**< Whether the file was opened already */
+static pthread_mutex_t dbLock = PTHREAD_MUTEX_INITIALIZER;
+
+static uint32_t pow3Cell[GAMEDB_MAX_N * GAMEDB_MAX_N];
+
+__attribute__((constructor)) static void gameDbInitTables()
+{
+    uint32_t weight = 1;
+    for (int idx = 0; idx < GAMEDB_MAX_N * GAMEDB_MAX_N; idx++)
+    {
+        pow3Cell[idx] = weight;
+        weight *= 3;
+    }
+}
+
+uint32_t gameDbEntryCount(int n)
+{
+    uint32_t count = 1;
+    for (int idx = 0; idx < n * n; idx++)
+    {
+        count *= 3;
+    }
+    return count;
+}
+
+uint32_t gameDbIndex(uint64_t me, uint64_t them, int n)
+{
+    (void)n; // bit idx is cell idx for every size, only the number of cells differs
+    uint32_t index = 0;
+    while (me)
+    {
+        index += pow3Cell[nkPopLowest(&me)];
+    }
+    while (them)
+    {
+        index += 2 * pow3Cell[nkPopLowest(&them)];
+    }
+    return index;
+}
+
+static const uint8_t *mapDatabase(int n, int k)
+{
+    char path[64];
+    snprintf(path, sizeof(path), GAMEDB_PATH_FMT, n, n, k);
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        LOG_INFO("Game-value database not found -> %s\n", path);
+        return NULL;
+    }
+
+    size_t size = sizeof(struct GameDbHeader) + gameDbEntryCount(n);
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size != (off_t)size)
+    {
+        LOG_WARN("Game-value database has the wrong size -> %s\n", path);
+        close(fd);
+        return NULL;
+    }
+
+    void *map = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+    {
+        LOG_ERROR("Error mapping game-value database -> %s\n", path);
+        return NULL;
+    }
+
+    const struct GameDbHeader *header = map;
+    if (memcmp(header->magic, GAMEDB_MAGIC, sizeof(header->magic)) != 0 || header->version != GAMEDB_VERSION ||
+        header->n != n || header->k != k || header->entryCount != gameDbEntryCount(n))
+    {
+        LOG_WARN("%s <- Not a game-value database for %dx%d K=%d\n", path, n, n, k);
+        munmap(map, size);
+        return NULL;
+    }
+
+    LOG_INFO("Mapped game-value database %s\n", path);
+    return (const uint8_t *)map + sizeof(struct GameDbHeader);
+}
+
+bool gameDbOpen(int n, int k)
+{
+    if (n < MIN_N || n > GAMEDB_MAX_N || !nkIsValidSize(n, k))
+    {
+        return false;
+    }
+
+    pthread_mutex_lock(&dbLock);
+    if (!dbTried[n][k])
+    {
+        dbEntries[n][k] = mapDatabase(n, k);
+        dbTried[n][k] = true;
+    }
+    bool isOpen = dbEntries[n][k] != NULL;
+    pthread_mutex_unlock(&dbLock);
+    return isOpen;
+}
+
+uint8_t gameDbProbe(uint64_t me, uint64_t them, int n, int k)
+{
+    if (!gameDbOpen(n, k))
+    {
+        return GAMEDB_UNKNOWN;
+    }
+    return dbEntries[n][k][gameDbIndex(me, them, n)];
+}
+
+bool gameDbBestMove(struct NKBoard b, struct Position *bestMove)
+{
+    uint8_t root = gameDbProbe(b.bot, b.player, b.n, b.k);
+    if (GAMEDB_RESULT(root) == GAMEDB_UNKNOWN || nkEmpty(&b) == 0)
+    {
+        return false;
+    }
+
+    // Rank each move from the bot's side: win (fastest first), draw, loss (slowest first)
+    int bestRank = -1;
+    for (uint64_t empty = nkEmpty(&b); empty;)
+    {
+        int cell = nkPopLowest(&empty);
+        uint64_t bot = b.bot | (1ULL << cell);
+        // after the move the player is to move
+        uint8_t reply = nkHasWin(bot, b.n, b.k) ? GAMEDB_ENTRY(GAMEDB_LOSS, 0) : gameDbProbe(b.player, bot, b.n, b.k);
+
+        int rank;
+        switch (GAMEDB_RESULT(reply))
+        {
+        case GAMEDB_LOSS:
+            rank = 200 - GAMEDB_DISTANCE(reply);
+            break;
+        case GAMEDB_DRAW:
+            rank = 100;
+            break;
+        case GAMEDB_WIN:
+            rank = GAMEDB_DISTANCE(reply);
+            break;
+        default:
+            rank = -1;
+        }
+
+        if (rank > bestRank)
+        {
+            bestRank = rank;
+            bestMove->row = cell / b.n;
+            bestMove->col = cell % b.n;
+        }
+    }
+    return bestRank >= 0;
+}
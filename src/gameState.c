@@ -0,0 +1,22 @@
+#include <gameState.h>
+
+void gsInit(struct GameState *s, int n, int k)
+{
+    memset(s, 0, sizeof(*s));
+    s->board.n = n;
+    s->board.k = k;
+    s->emptyCount = n * n;
+}
+
+void gsFromBoard(struct GameState *s, struct NKBoard b)
+{
+    gsInit(s, b.n, b.k);
+    for (uint64_t m = b.bot; m;)
+    {
+        gsMake(s, nkPopLowest(&m), BOT);
+    }
+    for (uint64_t m = b.player; m;)
+    {
+        gsMake(s, nkPopLowest(&m), PLAYER1);
+    }
+}
@@ -2,24 +2,14 @@
 
 /**  
  * @var int len_train
- * @brief Global variable to store the number of training dataset entries.
+ * @brief Number of entries in the training dataset file.
  * 
- * This variable tracks the size of the training dataset after splitting.
+ * Set when the dataset is split, so zero until this process has written the files.
  *  
  * @var int len_test
- * @brief Global variable to store the number of testing dataset entries.
+ * @brief Number of entries in the testing dataset file.
  * 
- * This variable tracks the size of the testing dataset after splitting. 
- *  
- * @var int randomNo[DATA_SIZE]
- * @brief Global array to store unique random indices for dataset splitting.
- * 
- * This array stores randomized indices used to split the dataset into training and testing subsets.
- * 
- * @var struct Dataset data[DATA_SIZE]
- * @brief Global array to store the dataset.
- * 
- * This array holds the Tic-Tac-Toe board states and their corresponding outcomes.
+ * Set when the dataset is split, so zero until this process has written the files.
  *
  * @var const char *trainingFile
  * @brief Global variable to store the path for the training dataset file.
@@ -32,24 +22,23 @@
  * This variable holds the full path to the testing dataset file for reading and writing.
  * 
  */
-int len_train = 0;
-int len_test = 0;
-int randomNo[DATA_SIZE];
-struct Dataset data[DATA_SIZE];
+static int len_train = 0;
+static int len_test = 0;
 
 // to write to directory before
 const char *trainingFile = RES_PATH "" TRAIN_PATH "" DATA_PATH;
 const char *testingFile = RES_PATH "" TEST_PATH "" DATA_PATH;
 
-int readDataset(const char *filename, bool split)
+int readDataset(const char *filename, bool split, struct Dataset data[DATA_SIZE])
 {
     FILE *file = fopen(filename, "r");
     if (!file)
     {
-        PRINT_DEBUG("[ERROR] Error opening file.\n");
+        LOG_ERROR("[ERROR] Error opening file.\n");
         return BAD_PARAM;
     }
 
+    int randomNo[DATA_SIZE];
     if (split)
     {
         // get an array of random int where each position is different
@@ -75,19 +64,21 @@ int readDataset(const char *filename, bool split)
 
         if (token != NULL)
         {
-            strncpy(data[split ? randomNo[i] : i].outcome, token, sizeof(data[split ? randomNo[i] : i].outcome) - 1);
+            struct Dataset *entry = &data[split ? randomNo[i] : i];
+            strncpy(entry->outcome, token, sizeof(entry->outcome) - 1);
+            entry->outcome[sizeof(entry->outcome) - 1] = '\0'; // the caller's array may hold anything
         }
     }
     fclose(file);
 
     if (split)
     {
-        return splitFile();
+        return splitFile(data);
     }
     return SUCCESS;
 }
 
-static int splitFile()
+static int splitFile(const struct Dataset data[DATA_SIZE])
 {
     // get 80% and 20% respectively
     int eighty = len_train = 0.8 * DATA_SIZE;
@@ -98,7 +89,7 @@ static int splitFile()
     trainFile = fopen(trainingFile, "w");
     if (!trainFile)
     {
-        PRINT_DEBUG("[ERROR] Error opening file.\n");
+        LOG_ERROR("[ERROR] Error opening file.\n");
         return BAD_PARAM;
     }
 
@@ -121,7 +112,7 @@ static int splitFile()
     testFile = fopen(testingFile, "w");
     if (!testFile)
     {
-        PRINT_DEBUG("[ERROR] Error opening file.\n");
+        LOG_ERROR("[ERROR] Error opening file.\n");
         return BAD_PARAM;
     }
 
@@ -164,18 +155,16 @@ static void getRandomNo(int random[DATA_SIZE])
     }
 }
 
-int getTrainingData(struct Dataset **d)
+int getTrainingData(struct Dataset data[DATA_SIZE])
 {
     memset(data, 0, len_train * sizeof(struct Dataset));
-    readDataset(trainingFile, false);
-    *d = data;
+    readDataset(trainingFile, false, data);
     return len_train;
 }
 
-int getTestingData(struct Dataset **d)
+int getTestingData(struct Dataset data[DATA_SIZE])
 {
     memset(data, 0, len_test * sizeof(struct Dataset));
-    readDataset(testingFile, false);
-    *d = data;
+    readDataset(testingFile, false, data);
     return len_test;
 }
@@ -0,0 +1,243 @@
+#include <logger.h>
+#include <strings.h>
+#include <pthread.h>
+#include <stdarg.h>
+
+#define LOG_RING_MASK (LOG_RING_RECORDS - 1)
+
+/**
+ * @struct LogRecord
+ * @brief One formatted record in a ring.
+ */
+struct LogRecord
+{
+    int length;
+    char text[LOG_MESSAGE_MAX];
+};
+
+/**
+ * @struct LogRing
+ * @brief Records of one thread waiting for the drainer.
+ *
+ * Only the owning thread moves `head` and only the drainer moves `tail`, so the ring
+ * needs no lock: a record is published by the release store of `head` and its slot is
+ * handed back by the release store of `tail`.
+ */
+struct LogRing
+{
+    struct LogRecord records[LOG_RING_RECORDS];
+    uint32_t head;         /**< Records written */
+    uint32_t tail;         /**< Records drained */
+    uint64_t dropped;      /**< Records the owner found no room for */
+    uint64_t reported;     /**< Part of `dropped` already reported in the log, drainer only */
+    bool inUse;            /**< Whether a running thread owns the ring */
+    struct LogRing *next;  /**< Set before the ring is published, never changed */
+};
+
+int logLevel = LOG_DEFAULT_LEVEL;
+
+static struct LogRing *rings = NULL; /**< Every ring, rings of exited threads included */
+static pthread_mutex_t drainLock = PTHREAD_MUTEX_INITIALIZER; /**< Held while draining and writing the log file */
+static FILE *logFile = NULL;         /**< NULL for stdout, guarded by `drainLock` */
+static bool isSynchronous = false;   /**< Every record is written at once: no drainer, or exiting */
+static pthread_once_t logOnce = PTHREAD_ONCE_INIT;
+static pthread_key_t ringKey;        /**< Hands a thread's ring back when it exits */
+
+static __thread struct LogRing *ring = NULL;
+
+// Writes the records of every ring to the log file; drainLock held
+static int drainRings()
+{
+    FILE *file = (logFile != NULL) ? logFile : stdout;
+    int written = 0;
+    for (struct LogRing *r = __atomic_load_n(&rings, __ATOMIC_ACQUIRE); r != NULL; r = r->next)
+    {
+        uint32_t head = __atomic_load_n(&r->head, __ATOMIC_ACQUIRE);
+        for (uint32_t tail = r->tail; tail != head; tail++)
+        {
+            const struct LogRecord *record = &r->records[tail & LOG_RING_MASK];
+            fwrite(record->text, 1, record->length, file);
+            written++;
+        }
+        __atomic_store_n(&r->tail, head, __ATOMIC_RELEASE);
+
+        uint64_t dropped = __atomic_load_n(&r->dropped, __ATOMIC_RELAXED);
+        if (dropped != r->reported)
+        {
+            fprintf(file, "[LOG] %llu records dropped, their thread logged faster than the log file took them\n",
+                    (unsigned long long)(dropped - r->reported));
+            r->reported = dropped;
+            written++;
+        }
+    }
+    if (written > 0)
+    {
+        fflush(file);
+    }
+    return written;
+}
+
+static void *drainMain(void *arg)
+{
+    (void)arg;
+    int sleepMs = 1;
+    while (!__atomic_load_n(&isSynchronous, __ATOMIC_RELAXED))
+    {
+        pthread_mutex_lock(&drainLock);
+        int written = drainRings();
+        pthread_mutex_unlock(&drainLock);
+
+        // back off while idle, up to LOG_DRAIN_MS
+        sleepMs = (written > 0) ? 1 : (2 * sleepMs < LOG_DRAIN_MS) ? 2 * sleepMs : LOG_DRAIN_MS;
+        struct timespec pause = {0, sleepMs * 1000000L};
+        nanosleep(&pause, NULL);
+    }
+    return NULL;
+}
+
+static void releaseRing(void *arg)
+{
+    struct LogRing *r = arg;
+    __atomic_store_n(&r->inUse, false, __ATOMIC_RELEASE);
+}
+
+// Records logged by later exit handlers are written at once
+static void logShutdown()
+{
+    __atomic_store_n(&isSynchronous, true, __ATOMIC_RELAXED);
+    logFlush();
+}
+
+static void logInit()
+{
+    pthread_key_create(&ringKey, releaseRing);
+    atexit(logShutdown);
+
+    pthread_t drainer;
+    if (pthread_create(&drainer, NULL, drainMain, NULL) == 0)
+    {
+        pthread_detach(drainer);
+    }
+    else
+    {
+        isSynchronous = true;
+    }
+}
+
+__attribute__((constructor)) static void readLevelFromEnv()
+{
+    const char *name = getenv(LOG_ENV);
+    int level = (name != NULL) ? logParseLevel(name) : ERROR;
+    if (level != ERROR)
+    {
+        logLevel = level;
+    }
+}
+
+// Gives the calling thread a ring, one of an exited thread if there is one
+static struct LogRing *claimRing()
+{
+    pthread_once(&logOnce, logInit);
+
+    struct LogRing *r;
+    for (r = __atomic_load_n(&rings, __ATOMIC_ACQUIRE); r != NULL; r = r->next)
+    {
+        bool isFree = false;
+        if (__atomic_compare_exchange_n(&r->inUse, &isFree, true, false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED))
+        {
+            break;
+        }
+    }
+
+    if (r == NULL)
+    {
+        r = calloc(1, sizeof(struct LogRing));
+        if (r == NULL)
+        {
+            return NULL;
+        }
+        r->inUse = true;
+        r->next = __atomic_load_n(&rings, __ATOMIC_RELAXED);
+        while (!__atomic_compare_exchange_n(&rings, &r->next, r, false, __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+        {
+        }
+    }
+    pthread_setspecific(ringKey, r);
+    return r;
+}
+
+void logWrite(int level, const char *format, ...)
+{
+    if (ring == NULL && (ring = claimRing()) == NULL)
+    {
+        return;
+    }
+
+    uint32_t head = ring->head;
+    if (head - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) == LOG_RING_RECORDS)
+    {
+        if (level > LOG_LEVEL_WARN)
+        {
+            __atomic_add_fetch(&ring->dropped, 1, __ATOMIC_RELAXED);
+            return;
+        }
+        logFlush(); // errors and warnings are worth the wait
+    }
+
+    struct LogRecord *record = &ring->records[head & LOG_RING_MASK];
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(record->text, LOG_MESSAGE_MAX, format, args);
+    va_end(args);
+    record->length = (length < 0) ? 0 : (length < LOG_MESSAGE_MAX) ? length : LOG_MESSAGE_MAX - 1;
+    __atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+
+    if (__atomic_load_n(&isSynchronous, __ATOMIC_RELAXED))
+    {
+        logFlush();
+    }
+}
+
+void logSetLevel(int level)
+{
+    level = (level < LOG_LEVEL_ERROR) ? LOG_LEVEL_ERROR : (level > LOG_LEVEL_TRACE) ? LOG_LEVEL_TRACE : level;
+    __atomic_store_n(&logLevel, level, __ATOMIC_RELAXED);
+}
+
+int logParseLevel(const char *name)
+{
+    static const char *names[] = {"error", "warn", "info", "debug", "trace"};
+    for (int level = LOG_LEVEL_ERROR; level <= LOG_LEVEL_TRACE; level++)
+    {
+        if (strcasecmp(name, names[level]) == 0 || (name[0] == '0' + level && name[1] == '\0'))
+        {
+            return level;
+        }
+    }
+    return ERROR;
+}
+
+void logSetFile(FILE *file)
+{
+    pthread_mutex_lock(&drainLock);
+    drainRings();
+    logFile = file;
+    pthread_mutex_unlock(&drainLock);
+}
+
+void logFlush()
+{
+    pthread_mutex_lock(&drainLock);
+    drainRings();
+    pthread_mutex_unlock(&drainLock);
+}
+
+uint64_t logDropped()
+{
+    uint64_t dropped = 0;
+    for (struct LogRing *r = __atomic_load_n(&rings, __ATOMIC_ACQUIRE); r != NULL; r = r->next)
+    {
+        dropped += __atomic_load_n(&r->dropped, __ATOMIC_RELAXED);
+    }
+    return dropped;
+}
@@ -8,15 +8,40 @@ int iPlayer1_score = 0;
 int iPlayer2_score = 0;
 int iTie_score = 0;
 int iGameState = PLAY;
-int iBoard[3][3];
-int iWinPos[3][3];
+int iBoard[MAX_N][MAX_N];
+int iWinPos[MAX_N][MAX_N];
+int iBoardSize = 3;
+int iWinLength = 3;
+struct Engine *engine;
+struct Game *game;
 
 bool isPlayer1Turn = true;
 bool isMLAvail = true;
+bool isBotThinking = false;
+bool isBotWorkerAvail = false;
 
 struct PlayerMode playerMode = {"2P", MODE_2P};
 
-GtkWidget *btnGrid[3][3];
+GtkWidget *btnGrid[MAX_N][MAX_N];
+
+static pthread_t botThread;
+static pthread_mutex_t botLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t botWake = PTHREAD_COND_INITIALIZER;
+static struct BotJob botJob;    /**< Move waiting for the worker, guarded by botLock */
+static bool hasBotJob;          /**< Whether botJob is waiting, guarded by botLock */
+static bool hasRetrainJob;      /**< Whether the ML model waits to be retrained, guarded by botLock */
+static unsigned botGeneration;  /**< Bumped by every cancel, main thread only */
+
+static struct BotJob ponderJob;         /**< Board after the bot's move, human to move, guarded by botLock */
+static bool hasPonderJob;               /**< Whether replies are left to ponder, guarded by botLock */
+static uint64_t ponderLeft;             /**< Human replies not pondered yet, guarded by botLock */
+static unsigned ponderGeneration;       /**< Bumped when the cache is refilled or cleared, guarded by botLock */
+static bool isPonderSearching;          /**< Whether ponderBoard is being searched, guarded by botLock */
+static struct NKBoard ponderBoard;      /**< Reply being pondered, guarded by botLock */
+static struct BotJob promotedJob;       /**< Move asked for on ponderBoard while it was searched, guarded by botLock */
+static bool hasPromotedJob;             /**< Whether promotedJob waits for the ponder search, guarded by botLock */
+static struct PonderEntry ponderCache[PONDER_CACHE_SIZE]; /**< Pondered replies, guarded by botLock */
+static int ponderCacheCount;
 
 /*===============================================================================================
 END OF GLOBAL DECLARATION
@@ -28,15 +53,17 @@ GUI FUNCTIONS
 
 static void clearGrid()
 {
+    cancelBotMove();
     isPlayer1Turn = true;
-    for (int i = 0; i < 3; i++)
+    for (int i = 0; i < iBoardSize; i++)
     {
-        for (int j = 0; j < 3; j++)
+        for (int j = 0; j < iBoardSize; j++)
         {
             gtk_button_set_label(GTK_BUTTON(btnGrid[i][j]), ""); // Clear the button labels
             iBoard[i][j] = 0;
         }
     }
+    gameReset(game);
 }
 
 static void updateScoreBtn(gpointer data)
@@ -62,6 +89,11 @@ void on_btnGrid_clicked(GtkWidget *widget, gpointer data)
     const char *current_label = gtk_button_get_label(GTK_BUTTON(widget));
     BtnPos *btnPos = (BtnPos *)g_object_get_data(G_OBJECT(widget), "button-data");
 
+    if (isBotThinking)
+    {
+        return; // the bot's move is on its way
+    }
+
     if (iGameState != PLAY)
     {
         iGameState = PLAY;
@@ -76,6 +108,7 @@ void on_btnGrid_clicked(GtkWidget *widget, gpointer data)
     }
 
     iBoard[btnPos->pos[0]][btnPos->pos[1]] = isPlayer1Turn ? PLAYER1 : BOT; // O (1), X(2), BOT is the same as player 2
+    gamePlay(game, btnPos->pos[0], btnPos->pos[1]);
 
     // Update the button text, for example, with an "O"
     gtk_button_set_label(GTK_BUTTON(widget), isPlayer1Turn ? "O" : "X");
@@ -92,22 +125,27 @@ void on_btnGrid_clicked(GtkWidget *widget, gpointer data)
             return;
         }
 
-        doBOTmove();
-        retVal = chkPlayerWin();
+        doBOTmove(data); // the turn ends in onBotMoveReady()
+        return;
     }
 
+    finishTurn(retVal, data);
+}
+
+static void finishTurn(int retVal, gpointer data)
+{
     if (retVal == WIN)
     {
         showWin();
-        PRINT_DEBUG("[DEBUG] GAME RESULT -> %s Win\n", isPlayer1Turn ? "Player 1" : playerMode.mode == MODE_2P ? "Player 2"
-                                                                                                               : "BOT");
+        LOG_DEBUG("[DEBUG] GAME RESULT -> %s Win\n", isPlayer1Turn ? "Player 1" : playerMode.mode == MODE_2P ? "Player 2"
+                                                                                                             : "BOT");
         isPlayer1Turn ? iPlayer1_score++ : iPlayer2_score++;
         iGameState = WIN;
     }
 
     if (retVal == TIE)
     {
-        PRINT_DEBUG("[DEBUG] GAME RESULT -> TIE\n");
+        LOG_DEBUG("[DEBUG] GAME RESULT -> TIE\n");
         iTie_score++;
         iGameState = TIE;
     }
@@ -121,8 +159,7 @@ void on_btnGrid_clicked(GtkWidget *widget, gpointer data)
     {
         if (retVal == WIN || retVal == TIE)
         {
-            readDataset(RES_PATH "" DATA_PATH, true);
-            initData();
+            retrainML();
         }
     }
     updateScoreBtn(data);
@@ -130,7 +167,7 @@ void on_btnGrid_clicked(GtkWidget *widget, gpointer data)
 
 void on_btnScore_clicked(GtkWidget *widget, gpointer data)
 {
-    playerMode.mode = (playerMode.mode > 1 ? MODE_2P : ++playerMode.mode);
+    playerMode.mode = (playerMode.mode > 2 ? MODE_2P : ++playerMode.mode);
     switch (playerMode.mode)
     {
     case MODE_MM:
@@ -138,17 +175,23 @@ void on_btnScore_clicked(GtkWidget *widget, gpointer data)
         break;
 
     case MODE_ML:
-        if (isMLAvail)
+        if (isMLAvail && iBoardSize == 3 && iWinLength == 3) // the dataset only covers 3x3
         {
             strncpy(playerMode.txt, "ML", sizeof(playerMode.txt));
             break;
         }
+        playerMode.mode = MODE_MC;
+        // fall through
+
+    case MODE_MC:
+        strncpy(playerMode.txt, "MC", sizeof(playerMode.txt));
+        break;
 
     default:
         playerMode.mode = MODE_2P;
         strncpy(playerMode.txt, "2P", sizeof(playerMode.txt));
     }
-    PRINT_DEBUG("playerMode: %d\n", playerMode.mode);
+    LOG_DEBUG("playerMode: %d\n", playerMode.mode);
     isPlayer1Turn = true;
     iPlayer1_score = iPlayer2_score = iTie_score = 0;
     
@@ -158,9 +201,9 @@ void on_btnScore_clicked(GtkWidget *widget, gpointer data)
 
 static void showWin()
 {
-    for (int i = 0; i < 3; i++)
+    for (int i = 0; i < iBoardSize; i++)
     {
-        for (int j = 0; j < 3; j++)
+        for (int j = 0; j < iBoardSize; j++)
         {
             if (iWinPos[i][j] != WIN)
             {
@@ -178,101 +221,314 @@ END OF GUI FUNCTIONS
 LOGIC FUNCTIONS
 ===============================================================================================*/
 
-static int doBOTmove()
+static struct Position thinkBotMove(const struct BotJob *job)
 {
     struct Position botMove;
-    if (playerMode.mode == MODE_MM)
+    struct NKBoard b = job->board;
+
+    if (job->mode != MODE_MM)
+    {
+        return gameSearch(game, b, job->mode);
+    }
+
+    PROFILE_BEGIN("Minimax Move");
+    if (job->isRandom)
+    {
+        PROFILE_BEGIN("Minimax Random Move");
+        botMove = randomMove(&b);
+        LOG_DEBUG("Random Move -> R:%d C:%d\n", botMove.row, botMove.col);
+        PROFILE_END();
+    }
+    else
+    {
+        botMove = gameSearch(game, b, MODE_MM);
+    }
+    PROFILE_END();
+    return botMove;
+}
+
+static struct Position randomMove(const struct NKBoard *b)
+{
+    uint64_t empty = nkEmpty(b);
+    for (int skip = rand() % __builtin_popcountll(empty); skip > 0; skip--)
     {
-        startElapseTime();
+        nkPopLowest(&empty);
+    }
+    int cell = nkPopLowest(&empty);
+    return (struct Position){cell / b->n, cell % b->n};
+}
+
+static bool isSameBoard(const struct NKBoard *a, const struct NKBoard *b)
+{
+    return a->bot == b->bot && a->player == b->player && a->n == b->n && a->k == b->k;
+}
+
+static int doBOTmove(gpointer data)
+{
+    struct BotJob job = {.board = gameBoard(game), .mode = playerMode.mode, .generation = botGeneration, .data = data};
 #if !(MINIMAX_GODMODE)
-        if (rand() % 100 < 80)
+    job.isRandom = job.mode == MODE_MM && rand() % 100 >= 80; // 20% of Minimax moves are random
 #endif
+    isBotThinking = true;
+
+    if (!isBotWorkerAvail)
+    {
+        struct BotResult *result = g_new(struct BotResult, 1);
+        *result = (struct BotResult){thinkBotMove(&job), job.generation, data};
+        onBotMoveReady(result);
+        return SUCCESS;
+    }
+
+    struct Position botMove = {ERROR, ERROR};
+    pthread_mutex_lock(&botLock);
+    hasPonderJob = false; // the human has picked their reply, the other ones are useless now
+
+    for (int i = 0; i < ponderCacheCount && !job.isRandom; i++)
+    {
+        if (ponderCache[i].mode == job.mode && isSameBoard(&ponderCache[i].board, &job.board))
         {
-            botMove = findBestMove(iBoard);
+            botMove = ponderCache[i].move;
+            break;
         }
-#if !(MINIMAX_GODMODE)
-        else
-        {
-            startElapseTime();
-            int randRow = rand() % 3;
-            int randCol = rand() % 3;
-            bool bIsDone = false;
+    }
 
-            while (!bIsDone)
-            {
-                if (iBoard[randRow][randCol] == EMPTY)
-                {
-                    PRINT_DEBUG("Random Move -> R:%d C:%d\n", randRow, randCol);
-                    botMove.row = randRow;
-                    botMove.col = randCol;
-                    bIsDone = !bIsDone;
-                }
-                else
-                {
-                    randRow = rand() % 3;
-                    randCol = rand() % 3;
-                }
-            }
-            stopElapseTime("Minimax Random Move");
-        }
-#endif
-        stopElapseTime("Minimax Move");
+    if (botMove.row == ERROR && !job.isRandom && isPonderSearching && isSameBoard(&ponderBoard, &job.board))
+    {
+        promotedJob = job; // being pondered right now, botWorker() plays it once found
+        hasPromotedJob = true;
     }
-    else // ML mode, sets ML as default if for some reason playermode.mode has expected value.
+    else if (botMove.row == ERROR)
     {
-        if (isMLAvail)
+        botJob = job;
+        hasBotJob = true;
+        if (isPonderSearching)
         {
-            botMove = getBestPosition(iBoard, 'x');
+            gameCancel(game, true); // stop pondering a reply that was not played
         }
+        pthread_cond_signal(&botWake);
     }
+    pthread_mutex_unlock(&botLock);
 
-    iBoard[botMove.row][botMove.col] = BOT;
-    gtk_button_set_label(GTK_BUTTON(btnGrid[botMove.row][botMove.col]), "X");
+    if (botMove.row != ERROR)
+    {
+        LOG_DEBUG("Best move found in ponder cache: Row = %d, Col = %d\n", botMove.row, botMove.col);
+        struct BotResult *result = g_new(struct BotResult, 1);
+        *result = (struct BotResult){botMove, job.generation, data};
+        onBotMoveReady(result);
+    }
     return SUCCESS;
 }
 
-static int chkPlayerWin()
+static gboolean onBotMoveReady(gpointer arg)
 {
-    // check both dia
-    if (iBoard[0][0] == iBoard[1][1] && iBoard[1][1] == iBoard[2][2] && iBoard[0][0] != 0)
+    struct BotResult *result = arg;
+
+    // a move for a board that was reset or a mode that was left is dropped
+    if (isBotThinking && result->generation == botGeneration)
     {
-        iWinPos[0][0] = iWinPos[1][1] = iWinPos[2][2] = WIN;
-        return WIN;
+        isBotThinking = false;
+        struct Position botMove = result->move;
+        if (botMove.row == ERROR)
+        {
+            // the turn must still be played, or the board and isPlayer1Turn fall out of step
+            struct NKBoard board = gameBoard(game);
+            botMove = randomMove(&board);
+            LOG_WARN("[WARN] The bot found no move, playing R:%d C:%d at random\n", botMove.row, botMove.col);
+        }
+        iBoard[botMove.row][botMove.col] = BOT;
+        gamePlay(game, botMove.row, botMove.col);
+        gtk_button_set_label(GTK_BUTTON(btnGrid[botMove.row][botMove.col]), "X");
+        finishTurn(chkPlayerWin(), result->data);
+
+        if (iGameState == PLAY)
+        {
+            startPondering();
+        }
     }
 
-    if (iBoard[0][2] == iBoard[1][1] && iBoard[1][1] == iBoard[2][0] && iBoard[0][2] != 0)
+    g_free(result);
+    return G_SOURCE_REMOVE;
+}
+
+static void startPondering()
+{
+    if (!isBotWorkerAvail || (playerMode.mode != MODE_MM && playerMode.mode != MODE_MC))
     {
-        iWinPos[0][2] = iWinPos[1][1] = iWinPos[2][0] = WIN;
-        return WIN;
+        return;
     }
 
-    // check rows and col
-    for (int i = 0; i < 3; i++)
+    pthread_mutex_lock(&botLock);
+    ponderJob = (struct BotJob){.board = gameBoard(game), .mode = playerMode.mode};
+    ponderLeft = nkEmpty(&ponderJob.board);
+    ponderCacheCount = 0;
+    ponderGeneration++;
+    hasPonderJob = true;
+    pthread_cond_signal(&botWake);
+    pthread_mutex_unlock(&botLock);
+}
+
+static void cancelBotMove()
+{
+    pthread_mutex_lock(&botLock);
+    hasPonderJob = false;
+    hasPromotedJob = false;
+    ponderCacheCount = 0;
+    ponderGeneration++; // a reply being pondered is not stored
+    if (isPonderSearching)
     {
-        // Check rows
-        if (iBoard[i][0] == iBoard[i][1] && iBoard[i][1] == iBoard[i][2] && iBoard[i][0] != 0)
-        {
-            iWinPos[i][0] = iWinPos[i][1] = iWinPos[i][2] = WIN;
-            return WIN;
-        }
-        // Check columns
-        if (iBoard[0][i] == iBoard[1][i] && iBoard[1][i] == iBoard[2][i] && iBoard[0][i] != 0)
+        gameCancel(game, true);
+    }
+    pthread_mutex_unlock(&botLock);
+
+    if (!isBotThinking)
+    {
+        return;
+    }
+    isBotThinking = false;
+    botGeneration++;
+
+    pthread_mutex_lock(&botLock);
+    hasBotJob = false;      // not started yet
+    gameCancel(game, true); // or started, cleared again when the next move is taken
+    pthread_mutex_unlock(&botLock);
+}
+
+static void retrainML()
+{
+    if (!isBotWorkerAvail)
+    {
+        engineRetrainModel(engine);
+        return;
+    }
+
+    pthread_mutex_lock(&botLock);
+    hasRetrainJob = true;
+    pthread_cond_signal(&botWake);
+    pthread_mutex_unlock(&botLock);
+}
+
+static bool nextPonderBoard(struct NKBoard *reply)
+{
+    while (ponderLeft != 0)
+    {
+        // replies next to the stones first, they are the ones the human is likely to play
+        uint64_t near = nkNeighbours(&ponderJob.board) & ponderLeft;
+        uint64_t pick = near ? near : ponderLeft;
+        int cell = __builtin_ctzll(pick);
+        ponderLeft &= ~(1ULL << cell);
+
+        *reply = ponderJob.board;
+        reply->player |= 1ULL << cell;
+        // the bot does not move after a winning or filling reply
+        if (!nkHasWin(reply->player, reply->n, reply->k) && nkEmpty(reply) != 0)
         {
-            iWinPos[0][i] = iWinPos[1][i] = iWinPos[2][i] = WIN;
-            return WIN;
+            return true;
         }
     }
+    return false;
+}
 
-    // check for unclicked grid, if none left then tie
-    for (int i = 0; i < 3; i++)
+static void *botWorker(void *arg)
+{
+    (void)arg;
+    for (;;)
     {
-        for (int j = 0; j < 3; j++)
+        pthread_mutex_lock(&botLock);
+        while (!hasBotJob && !hasRetrainJob && !hasPonderJob)
         {
-            if (iBoard[i][j] == 0)
+            pthread_cond_wait(&botWake, &botLock);
+        }
+
+        // the model is retrained first, so the next ML move already uses it;
+        // pondering only runs when there is nothing else to do
+        bool isRetrain = hasRetrainJob;
+        bool isPonder = !isRetrain && !hasBotJob;
+        struct BotJob job = botJob;
+        unsigned generation = ponderGeneration;
+        if (isRetrain)
+        {
+            hasRetrainJob = false;
+        }
+        else if (isPonder)
+        {
+            job = ponderJob;
+            hasPonderJob = nextPonderBoard(&job.board);
+            isPonderSearching = hasPonderJob;
+            ponderBoard = job.board;
+            gameCancel(game, false);
+        }
+        else
+        {
+            hasBotJob = false;
+            gameCancel(game, false);
+        }
+        pthread_mutex_unlock(&botLock);
+
+        if (isRetrain)
+        {
+            engineRetrainModel(engine);
+            continue;
+        }
+        if (isPonder && !isPonderSearching)
+        {
+            continue; // every reply is pondered
+        }
+
+        struct BotResult *result = g_new(struct BotResult, 1);
+        *result = (struct BotResult){isPonder ? gameSearch(game, job.board, job.mode) : thinkBotMove(&job), job.generation, job.data};
+
+        if (isPonder)
+        {
+            pthread_mutex_lock(&botLock);
+            isPonderSearching = false;
+            bool isValid = !gameIsCancelled(game) && generation == ponderGeneration;
+            if (hasPromotedJob)
+            {
+                // the human played this reply while it was searched
+                hasPromotedJob = false;
+                result->generation = promotedJob.generation;
+                result->data = promotedJob.data;
+                result->move = isValid ? result->move : (struct Position){ERROR, ERROR};
+            }
+            else
             {
-                return PLAY;
+                if (isValid && ponderCacheCount < PONDER_CACHE_SIZE)
+                {
+                    ponderCache[ponderCacheCount++] = (struct PonderEntry){job.board, job.mode, result->move};
+                }
+                g_free(result);
+                result = NULL;
             }
+            pthread_mutex_unlock(&botLock);
+        }
+
+        if (result != NULL)
+        {
+            g_idle_add(onBotMoveReady, result); // applied on the GTK main thread
+        }
+    }
+    return NULL;
+}
+
+static int chkPlayerWin()
+{
+    // the game counts every completed row, col and dia as moves are made
+    uint64_t line = gameWinLine(game);
+    if (line != 0)
+    {
+        for (uint64_t m = line; m;)
+        {
+            int idx = nkPopLowest(&m);
+            iWinPos[idx / iBoardSize][idx % iBoardSize] = WIN;
         }
+        return WIN;
+    }
+
+    // check for unclicked grid, if none left then tie
+    struct NKBoard b = gameBoard(game);
+    if (nkEmpty(&b) != 0)
+    {
+        return PLAY;
     }
 
     return TIE;
@@ -295,20 +551,21 @@ MAIN
  * The game board and score are displayed, and event listeners are attached to buttons.
  * 
  * @param argc The number of arguments passed to the program.
- * @param argv The list of arguments passed to the program.
+ * @param argv The list of arguments passed to the program, optionally `N K` to play on an
+ *             N x N board won by K in a row (see `nkIsValidSize()`).
  * @return SUCCESS if the program runs successfully.
- * @see initData, on_btnScore_clicked, on_btnGrid_clicked, btnGrid
+ * @see engineCreate, gameCreate, on_btnScore_clicked, on_btnGrid_clicked, btnGrid
  */
 int main(int argc, char *argv[])
 {
-    int retVal = SUCCESS;
     srand(time(NULL));
 
-    retVal = initData();
-    if (retVal != SUCCESS) // disable ML
+    engine = engineCreate(NULL); // trains the ML model and maps the minimax lookup file
+    if (engine == NULL)
     {
-        isMLAvail = false;
+        return ERROR;
     }
+    isMLAvail = engineHasModel(engine); // disable ML without a dataset
 
     GtkWidget *window;
     GtkWidget *grid;
@@ -317,6 +574,38 @@ int main(int argc, char *argv[])
     // Initialize GTK
     gtk_init(&argc, &argv);
 
+    // Optional board size: ./TicTacToe N K
+    if (argc == 3)
+    {
+        int n = atoi(argv[1]);
+        int k = atoi(argv[2]);
+        if (nkIsValidSize(n, k))
+        {
+            iBoardSize = n;
+            iWinLength = k;
+        }
+        else
+        {
+            LOG_WARN("[WARN] Unsupported board %s x %s (K = %s), using 3x3\n", argv[1], argv[1], argv[2]);
+        }
+    }
+    game = gameCreate(engine, iBoardSize, iWinLength);
+    if (game == NULL)
+    {
+        return ERROR;
+    }
+
+    // Bot moves are searched off the GTK main thread so the window keeps drawing
+    isBotWorkerAvail = pthread_create(&botThread, NULL, botWorker, NULL) == 0;
+    if (isBotWorkerAvail)
+    {
+        pthread_detach(botThread);
+    }
+    else
+    {
+        LOG_WARN("[WARN] Could not start the bot thread, the bot will think on the GUI thread\n");
+    }
+
     // Create a new window
     window = gtk_window_new(GTK_WINDOW_TOPLEVEL);
     gtk_window_set_title(GTK_WINDOW(window), "Tic-Tac-Toe");
@@ -350,12 +639,12 @@ int main(int argc, char *argv[])
     score_button = gtk_button_new_with_label("");
     gtk_label_set_markup(GTK_LABEL(gtk_bin_get_child(GTK_BIN(score_button))), "<b>Player 1 (O): 0</b>   |   TIE: 0   |   Player 2 (X): 0   |  [2P]  ");
     g_signal_connect(score_button, "clicked", G_CALLBACK(on_btnScore_clicked), score_button);
-    gtk_grid_attach(GTK_GRID(grid), score_button, 0, 3, 3, 1); // Attach score button below the grid
+    gtk_grid_attach(GTK_GRID(grid), score_button, 0, iBoardSize, iBoardSize, 1); // Attach score button below the grid
 
-    // Create the 9 btnGrid and add them to the grid
-    for (int i = 0; i < 3; i++)
+    // Create the N x N btnGrid and add them to the grid
+    for (int i = 0; i < iBoardSize; i++)
     {
-        for (int j = 0; j < 3; j++)
+        for (int j = 0; j < iBoardSize; j++)
         {
             btnGrid[i][j] = gtk_button_new_with_label("");
 
@@ -372,7 +661,7 @@ int main(int argc, char *argv[])
     }
 
     // Make the btnGrid expand to fill the available space
-    for (int i = 0; i < 3; i++)
+    for (int i = 0; i < iBoardSize; i++)
     {
         gtk_widget_set_vexpand(btnGrid[i][0], TRUE);
         gtk_widget_set_hexpand(btnGrid[i][0], TRUE);
@@ -0,0 +1,309 @@
+#include <mcts.h>
+#include <minimax.h>
+#include <math.h>
+
+int mctsPlayouts = MCTS_PLAYOUTS;
+
+/**
+ * A thread's tree and everything its search needs, so threads share nothing while
+ * they run.
+ */
+struct MCTSTree
+{
+    struct MCTSNode *nodes;  /**< Node block, index 0 is the root */
+    int used;                /**< Nodes handed out */
+    int capacity;            /**< Nodes allocated in `nodes` */
+    int maxNodes;            /**< Nodes the block may grow to */
+    uint64_t rng;            /**< xorshift64 state */
+    struct NKBoard root;
+    long playoutLimit;       /**< Playouts to make, 0 to run until `deadline` */
+    struct timespec deadline;
+    const volatile bool *cancelled; /**< Cancel flag of the search's context */
+    const volatile bool *stopped;   /**< Stop flag of the search's context */
+    long playouts;           /**< Playouts made */
+};
+
+static uint64_t nextRandom(uint64_t *state)
+{
+    uint64_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return *state = x;
+}
+
+// Uniformly random set bit of a non-empty mask
+static int randomCell(uint64_t mask, uint64_t *rng)
+{
+    int skip = (int)((nextRandom(rng) >> 32) % (uint64_t)__builtin_popcountll(mask));
+    while (skip-- > 0)
+    {
+        mask &= mask - 1;
+    }
+    return __builtin_ctzll(mask);
+}
+
+// Doubles a tree's node block, at most to maxNodes; false once it cannot grow
+static bool growNodes(struct MCTSTree *tree)
+{
+    if (tree->capacity >= tree->maxNodes)
+    {
+        return false;
+    }
+    int capacity = (tree->capacity < MCTS_POOL_CHUNK) ? MCTS_POOL_CHUNK : tree->capacity * 2;
+    capacity = (capacity > tree->maxNodes) ? tree->maxNodes : capacity;
+
+    struct MCTSNode *nodes = realloc(tree->nodes, (size_t)capacity * sizeof(struct MCTSNode));
+    if (nodes == NULL)
+    {
+        tree->maxNodes = tree->capacity; // keep searching with the nodes it has
+        return false;
+    }
+    tree->nodes = nodes;
+    tree->capacity = capacity;
+    return true;
+}
+
+static int newNode(struct MCTSTree *tree, int parent, int move, bool isBotMove, const struct NKBoard *b)
+{
+    int idx = tree->used++;
+    struct MCTSNode *node = &tree->nodes[idx];
+    node->parent = parent;
+    node->firstChild = node->nextSibling = ERROR;
+    node->move = (int8_t)move;
+    node->isBotMove = isBotMove;
+    node->visits = 0;
+    node->wins = 0;
+
+    bool isOver = (move != ERROR) && nkHasWin(isBotMove ? b->bot : b->player, b->n, b->k);
+    node->untried = isOver ? 0 : nkNeighbours(b);
+
+    if (parent != ERROR)
+    {
+        node->nextSibling = tree->nodes[parent].firstChild;
+        tree->nodes[parent].firstChild = idx;
+    }
+    return idx;
+}
+
+static void playMove(struct NKBoard *b, int cell, bool isBot)
+{
+    if (isBot)
+    {
+        b->bot |= 1ULL << cell;
+    }
+    else
+    {
+        b->player |= 1ULL << cell;
+    }
+}
+
+// Random game from b; returns BOT, PLAYER1 or EMPTY for a draw
+static int playout(struct NKBoard b, bool isBotToMove, int lastMover, uint64_t *rng)
+{
+    if (lastMover != EMPTY && nkHasWin(lastMover == BOT ? b.bot : b.player, b.n, b.k))
+    {
+        return lastMover;
+    }
+
+    for (uint64_t empty = nkEmpty(&b); empty; isBotToMove = !isBotToMove)
+    {
+        int cell = randomCell(empty, rng);
+        empty &= ~(1ULL << cell);
+        playMove(&b, cell, isBotToMove);
+        if (nkHasWin(isBotToMove ? b.bot : b.player, b.n, b.k))
+        {
+            return isBotToMove ? BOT : PLAYER1;
+        }
+    }
+    return EMPTY;
+}
+
+static int selectChild(const struct MCTSTree *tree, const struct MCTSNode *node)
+{
+    float logParent = logf((float)node->visits);
+    float bestScore = -1;
+    int best = node->firstChild;
+
+    for (int c = node->firstChild; c != ERROR; c = tree->nodes[c].nextSibling)
+    {
+        const struct MCTSNode *child = &tree->nodes[c];
+        float score = child->wins / child->visits + MCTS_UCT_C * sqrtf(logParent / child->visits);
+        if (score > bestScore)
+        {
+            bestScore = score;
+            best = c;
+        }
+    }
+    return best;
+}
+
+static bool isPastDeadline(const struct timespec *deadline)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec > deadline->tv_sec || (now.tv_sec == deadline->tv_sec && now.tv_nsec >= deadline->tv_nsec);
+}
+
+static void mctsSearchTree(void *arg)
+{
+    struct MCTSTree *tree = arg;
+    tree->used = 0;
+    tree->playouts = 0;
+    newNode(tree, ERROR, ERROR, false, &tree->root);
+
+    // a stopped search still makes one playout so there is a move to return
+    while (!*tree->cancelled && (tree->playouts == 0 || !*tree->stopped) &&
+           (tree->playoutLimit > 0 ? tree->playouts < tree->playoutLimit
+                                   : (tree->playouts % MCTS_CLOCK_INTERVAL != 0 || !isPastDeadline(&tree->deadline))))
+    {
+        struct NKBoard b = tree->root;
+        int idx = 0;
+        bool isBotToMove = true;
+
+        // Selection: follow UCT through fully expanded nodes
+        while (tree->nodes[idx].untried == 0 && tree->nodes[idx].firstChild != ERROR)
+        {
+            idx = selectChild(tree, &tree->nodes[idx]);
+            playMove(&b, tree->nodes[idx].move, isBotToMove);
+            isBotToMove = !isBotToMove;
+        }
+
+        // Expansion: one random untried move, while the block can hold it
+        if (tree->nodes[idx].untried != 0 && (tree->used < tree->capacity || growNodes(tree)))
+        {
+            int cell = randomCell(tree->nodes[idx].untried, &tree->rng);
+            tree->nodes[idx].untried &= ~(1ULL << cell);
+            playMove(&b, cell, isBotToMove);
+            idx = newNode(tree, idx, cell, isBotToMove, &b);
+            isBotToMove = !isBotToMove;
+        }
+
+        int lastMover = (idx == 0) ? EMPTY : tree->nodes[idx].isBotMove ? BOT : PLAYER1;
+        int winner = playout(b, isBotToMove, lastMover, &tree->rng);
+        tree->playouts++;
+
+        // Backpropagation: each node scores the result for the side that moved into it
+        for (; idx != ERROR; idx = tree->nodes[idx].parent)
+        {
+            struct MCTSNode *node = &tree->nodes[idx];
+            node->visits++;
+            if (winner == EMPTY)
+            {
+                node->wins += 0.5f;
+            }
+            else if ((winner == BOT) == node->isBotMove)
+            {
+                node->wins += 1.0f;
+            }
+        }
+    }
+}
+
+struct Position mctsRun(struct NKBoard b, long *playouts)
+{
+    struct Position bestMove = {ERROR, ERROR};
+    *playouts = 0;
+    if (nkEmpty(&b) == 0)
+    {
+        return bestMove;
+    }
+
+    struct SearchContext *ctx = searchContext();
+    struct MCTSTree trees[POOL_MAX_THREADS + 1]; // the workers and the calling thread
+    struct ThreadPool *pool = searchWorkers();
+    int threads = (pool != NULL) ? pool->threadCount + 1 : 1;
+    long playoutLimit = (ctx->mctsPlayouts > 0) ? (ctx->mctsPlayouts + threads - 1) / threads : 0;
+
+    // a playout adds at most one node, so a counted search needs no more than its playouts
+    int maxNodes = (playoutLimit > 0 && playoutLimit < MCTS_POOL_NODES) ? (int)playoutLimit + 1 : MCTS_POOL_NODES;
+
+    struct timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_sec += ctx->timeBudget / 1000;
+    deadline.tv_nsec += (long)(ctx->timeBudget % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L)
+    {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+
+    uint64_t seed = (uint64_t)time(NULL) ^ ((uint64_t)deadline.tv_nsec << 20);
+    for (int t = 0; t < threads; t++)
+    {
+        trees[t] = (struct MCTSTree){
+            .nodes = ctx->nodePools[t],
+            .capacity = ctx->nodePoolSizes[t],
+            .maxNodes = maxNodes,
+            .rng = seed + 0x9E3779B97F4A7C15ULL * (t + 1),
+            .root = b,
+            .playoutLimit = playoutLimit,
+            .deadline = deadline,
+            .cancelled = &ctx->cancelled,
+            .stopped = &ctx->stopped,
+        };
+        if (trees[t].capacity == 0 && !growNodes(&trees[t]))
+        {
+            LOG_ERROR("[ERROR] Could not allocate the MCTS node pool\n");
+            threads = t; // the trees already started still search
+            break;
+        }
+        if (t > 0)
+        {
+            poolSubmit(pool, mctsSearchTree, &trees[t]);
+        }
+    }
+    if (threads > 0)
+    {
+        mctsSearchTree(&trees[0]);
+    }
+    if (pool != NULL)
+    {
+        poolWait(pool);
+    }
+
+    // the blocks stay with the context, grown, for the next move
+    for (int t = 0; t < threads; t++)
+    {
+        ctx->nodePools[t] = trees[t].nodes;
+        ctx->nodePoolSizes[t] = trees[t].capacity;
+    }
+
+    // Root parallelisation: sum the visits of each root move over all trees
+    uint32_t visits[MAX_CELLS] = {0};
+    for (int t = 0; t < threads; t++)
+    {
+        *playouts += trees[t].playouts;
+        for (int c = trees[t].nodes[0].firstChild; c != ERROR; c = trees[t].nodes[c].nextSibling)
+        {
+            visits[trees[t].nodes[c].move] += trees[t].nodes[c].visits;
+        }
+    }
+
+    uint32_t bestVisits = 0;
+    for (int cell = 0; cell < b.n * b.n; cell++)
+    {
+        if (visits[cell] > bestVisits)
+        {
+            bestVisits = visits[cell];
+            bestMove.row = cell / b.n;
+            bestMove.col = cell % b.n;
+        }
+    }
+    return bestMove;
+}
+
+struct Position findBestMoveMCTS(struct NKBoard b)
+{
+    struct timespec start, end;
+    long playouts;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    struct Position bestMove = mctsRun(b, &playouts);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    double seconds = (end.tv_sec - start.tv_sec) + 1.0e-9 * (end.tv_nsec - start.tv_nsec);
+    LOG_DEBUG("[DEBUG] MCTS %ld playouts on %d threads in %.3f s (%.0f playouts/sec), move R:%d C:%d\n",
+              playouts, searchThreadCount(), seconds, playouts / (seconds > 0 ? seconds : 1), bestMove.row, bestMove.col);
+    return bestMove;
+}
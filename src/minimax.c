@@ -1,6 +1,24 @@
 #include <minimax.h>
+#include <mcts.h>
 
-int depthCounter = 0;
+__thread struct SearchContext *searchCtx = NULL;
+int searchMode = (MINIMAX_ALPHABETA) ? SEARCH_ALPHABETA : SEARCH_MINIMAX;
+int searchDepthLimit = (MINIMAX_GODMODE) ? NO_DEPTH_LIMIT : MINIMAX_DEPTH_LIMIT;
+int searchTimeBudget = MOVE_TIME_BUDGET_MS;
+int searchThreads = SEARCH_THREADS;
+
+static const int bbCellPriority[BB_CELLS] = {2, 1, 2, 1, 3, 1, 2, 1, 2}; // center 3, corners 2, edges 1
+static __thread int killerMoves[MAX_PLY][2];
+static __thread int historyTable[2][BB_CELLS];
+
+// Move ordering state is per thread, reset when a thread joins a new search
+static __thread int nkKillerMoves[NK_MAX_PLY][2];
+static __thread int nkHistoryTable[2][MAX_CELLS];
+static __thread unsigned nkThreadSearchId;
+static unsigned nkSearchIds;                /**< Last id handed to an N x N search, of any context */
+static __thread unsigned nkNodesSinceCheck; /**< Nodes this thread visited since it read the clock */
+
+static struct SearchContext defaultSearch;  /**< Context of the searches made outside `searchEnter()` */
 
 static int max(int a, int b)
 {
@@ -70,151 +88,964 @@ static int min(int a, int b)
 
 struct Position findBestMove(int board[3][3])
 {
-    int bestVal = -1000;
     struct Position bestMove;
+    searchContext();
+    searchStatsBegin(3, 3);
+
+#if !(DISABLE_MOVETABLE)
+    // Solved offline by genMoveTable, so perfect play costs one array load
+    const uint8_t *table = (searchCtx->depthLimit == NO_DEPTH_LIMIT)        ? moveTableGodmode
+                           : (searchCtx->depthLimit == MINIMAX_DEPTH_LIMIT) ? moveTableDepthLimited
+                                                                       : NULL;
+    int cell = table ? table[bbBase3(bbFromArray(board))] : MOVETABLE_NONE;
+    if (cell != MOVETABLE_NONE)
+    {
+        bestMove.row = BB_ROW(cell - 1);
+        bestMove.col = BB_COL(cell - 1);
+        LOG_DEBUG("Best move found in move table: Row = %d, Col = %d\n", bestMove.row, bestMove.col);
+        STATS_COUNT(lookupHits);
+        return searchFinish(STATS_SOURCE_MOVETABLE, bestMove);
+    }
+    if (table != NULL)
+    {
+        STATS_COUNT(lookupMisses);
+    }
+#endif
 
-    struct BoardState boardStates[MAX_BOARDS];
+    // Solved offline by solveRetrograde; only perfect play can use it
+    struct BitBoard bb = bbFromArray(board);
+    if (searchCtx->depthLimit == NO_DEPTH_LIMIT)
+    {
+        if (gameDbBestMove((struct NKBoard){bb.bot, bb.player, 3, 3}, &bestMove))
+        {
+            LOG_DEBUG("Best move found in game-value database: Row = %d, Col = %d\n", bestMove.row, bestMove.col);
+            STATS_COUNT(lookupHits);
+            return searchFinish(STATS_SOURCE_GAMEDB, bestMove);
+        }
+        STATS_COUNT(lookupMisses);
+    }
 
 #if !(DISABLE_LOOKUP)
-    startElapseTime();
-    int boardCount = loadBoardStates(boardStates);
-    stopElapseTime("Loading lookup table");
+    PROFILE_BEGIN("Loading lookup table");
+    loadBoardStates(); // maps the file on first use only
+    PROFILE_END();
 #endif
 
     bestMove.row = ERROR;
     bestMove.col = ERROR;
 
-    startElapseTime();
+    // moves are only shared between searches with the same settings
+    uint64_t key = bestMoveKey(MINIMAX_ENGINE_VERSION, searchCtx->mode, searchCtx->depthLimit, 3, 3);
 #if !(DISABLE_LOOKUP)
-    if (checkAndUpdateBestMove(board, &bestMove, boardStates, boardCount))
+    PROFILE_BEGIN("Find best move in lookup table");
+    bool isFound = checkAndUpdateBestMove(key, board, &bestMove);
+    PROFILE_END();
+    if (isFound)
     {
-        stopElapseTime("Find best move in lookup table");
-        PRINT_DEBUG("Best move found in memory: Row = %d, Col = %d\n", bestMove.row, bestMove.col);
+        LOG_DEBUG("Best move found in memory: Row = %d, Col = %d\n", bestMove.row, bestMove.col);
+        STATS_COUNT(lookupHits);
+        return searchFinish(STATS_SOURCE_LOOKUP, bestMove);
+    }
+    STATS_COUNT(lookupMisses);
+#endif
+
+    PROFILE_BEGIN("Minimax depth search");
+    bestMove = searchBestMove(board);
+    PROFILE_END();
+    writeBestMoveToFile(key, board, bestMove);
+
+    return searchFinish(STATS_SOURCE_SEARCH, bestMove);
+}
+
+struct Position searchBestMove(int board[3][3])
+{
+    int bestVal = -1000;
+    struct Position bestMove = {ERROR, ERROR};
+    searchContext();
+
+#if !(DISABLE_BITBOARD)
+    struct BitBoard bb = bbFromArray(board);
+    int moves[BB_CELLS];
+    int moveCount;
+
+    // Plain Minimax walks the empty cells in row-major order so ties resolve
+    // the same way as the array engine below. Alpha-beta searches the most
+    // promising cell first so the later root moves are refuted cheaply.
+    if (searchCtx->mode == SEARCH_ALPHABETA)
+    {
+        memset(killerMoves, ERROR, sizeof(killerMoves));
+        memset(historyTable, 0, sizeof(historyTable));
+        moveCount = bbOrderMoves(bb, 0, true, moves);
     }
     else
+    {
+        moveCount = 0;
+        for (uint16_t empty = bbEmpty(bb); empty;)
+        {
+            moves[moveCount++] = bbPopLowest(&empty);
+        }
+    }
+
+    for (int m = 0; m < moveCount; m++)
+    {
+        int idx = moves[m];
+        uint16_t bit = (uint16_t)(1u << idx);
+
+        struct BitBoard child = {(uint16_t)(bb.bot | bit), bb.player};
+        int moveVal = (searchCtx->mode == SEARCH_ALPHABETA)
+                          ? bbAlphaBeta(child, 0, bestVal, 1000, false)
+                          : bbMinimax(child, 0, false);
+        LOG_TRACE("[DEBUG] Depth exited at -> %llu\n", (unsigned long long)searchStats.nodes);
+
+        if (moveVal > bestVal)
+        {
+            bestMove.row = BB_ROW(idx);
+            bestMove.col = BB_COL(idx);
+            bestVal = moveVal;
+        }
+    }
+#else
+    // Traverse all cells, evaluate minimax function for
+    // all empty cells. And return the cell with optimal
+    // value.
+    struct BitBoard bb = bbFromArray(board);
+    struct GameState state;
+    gsFromBoard(&state, (struct NKBoard){bb.bot, bb.player, 3, 3});
+    for (uint64_t empty = gsEmpty(&state); empty;)
+    {
+        int idx = nkPopLowest(&empty);
+
+        // Make the move, compute evaluation function for it and undo it
+        gsMake(&state, idx, BOT);
+        int moveVal = minimax(&state, 0, false);
+        LOG_TRACE("[DEBUG] Depth exited at -> %llu\n", (unsigned long long)searchStats.nodes);
+        gsUnmake(&state, idx, BOT);
+
+        // If the value of the current move is more than the best value, then update best move
+        if (moveVal > bestVal)
+        {
+            bestMove.row = BB_ROW(idx);
+            bestMove.col = BB_COL(idx);
+            bestVal = moveVal;
+        }
+    }
 #endif
+    // searchStats is only cleared by the entry points, so direct callers see a running total
+    LOG_TRACE("[DEBUG] %s search done, %llu nodes counted\n",
+              (!(DISABLE_BITBOARD) && searchCtx->mode == SEARCH_ALPHABETA) ? "Alpha-beta" : "Minimax",
+              (unsigned long long)searchStats.nodes);
+    return bestMove;
+}
+
+struct Position findBestMoveNK(struct NKBoard b)
+{
+    searchContext();
+    if (b.n == 3 && b.k == 3)
     {
-        startElapseTime();
-        // Traverse all cells, evaluate minimax function for
-        // all empty cells. And return the cell with optimal
-        // value.
-        for (int i = 0; i < 3; i++)
+        // classic board: keep the solved move table and the lookup file
+        int board[3][3];
+        for (int idx = 0; idx < BB_CELLS; idx++)
         {
-            for (int j = 0; j < 3; j++)
+            board[BB_ROW(idx)][BB_COL(idx)] = (b.bot >> idx & 1) ? BOT : (b.player >> idx & 1) ? PLAYER1 : EMPTY;
+        }
+        return findBestMove(board);
+    }
+
+    struct Position bestMove;
+    searchStatsBegin(b.n, b.k);
+    if (gameDbBestMove(b, &bestMove))
+    {
+        LOG_DEBUG("Best move found in game-value database: Row = %d, Col = %d\n", bestMove.row, bestMove.col);
+        STATS_COUNT(lookupHits);
+        return searchFinish(STATS_SOURCE_GAMEDB, bestMove);
+    }
+    STATS_COUNT(lookupMisses);
+
+    PROFILE_BEGIN("N x N alpha-beta search");
+    bestMove = (searchCtx->timeBudget > 0) ? searchTimedNK(b, searchCtx->timeBudget)
+                                           : searchBestMoveNK(b, nkSearchDepth(b.n, b.k));
+    PROFILE_END();
+    return searchFinish(STATS_SOURCE_SEARCH, bestMove);
+}
+
+int nkSearchDepth(int n, int k)
+{
+    switch (NK_SIZE(n, k))
+    {
+    case NK_SIZE(4, 3):
+    case NK_SIZE(4, 4):
+        return n * n; // small enough to solve
+    case NK_SIZE(5, 4):
+        return 9;
+    case NK_SIZE(6, 4):
+        return 8;
+    default:
+        return 7;
+    }
+}
+
+struct Position searchBestMoveNK(struct NKBoard b, int depth)
+{
+    struct Position bestMove = {ERROR, ERROR};
+
+    searchContext()->searchId = __atomic_add_fetch(&nkSearchIds, 1, __ATOMIC_RELAXED);
+    nkPrepareThread();
+    searchCtx->timed = searchCtx->aborted = false;
+
+    int score = nkSearchRoot(b, depth, ERROR, &bestMove);
+    searchStats.depth = searchCtx->aborted ? 0 : depth;
+    LOG_TRACE("[DEBUG] %dx%d (K=%d) depth %d search done, %llu nodes counted, score %d\n",
+              b.n, b.n, b.k, depth, (unsigned long long)searchStats.nodes, score);
+    return bestMove;
+}
+
+struct Position searchTimedNK(struct NKBoard b, int budgetMs)
+{
+    struct Position bestMove = {ERROR, ERROR};
+    int maxDepth = __builtin_popcountll(nkEmpty(&b));
+
+    searchContext()->searchId = __atomic_add_fetch(&nkSearchIds, 1, __ATOMIC_RELAXED);
+    nkPrepareThread();
+
+    clock_gettime(CLOCK_MONOTONIC, &searchCtx->deadline);
+    searchCtx->deadline.tv_sec += budgetMs / 1000;
+    searchCtx->deadline.tv_nsec += (long)(budgetMs % 1000) * 1000000L;
+    if (searchCtx->deadline.tv_nsec >= 1000000000L)
+    {
+        searchCtx->deadline.tv_sec++;
+        searchCtx->deadline.tv_nsec -= 1000000000L;
+    }
+    searchCtx->aborted = false;
+    nkNodesSinceCheck = 0;
+
+    for (int depth = 1; depth <= maxDepth; depth++)
+    {
+        // depth 1 always completes so there is a move to return
+        searchCtx->timed = depth > 1;
+
+        struct Position move;
+        int firstMove = (bestMove.row == ERROR) ? ERROR : bestMove.row * b.n + bestMove.col;
+        int score = nkSearchRoot(b, depth, firstMove, &move);
+        if (searchCtx->aborted)
+        {
+            LOG_DEBUG("[DEBUG] Depth %d aborted after %d ms, keeping depth %d move\n", depth, budgetMs, depth - 1);
+            break;
+        }
+
+        bestMove = move;
+        searchStats.depth = depth;
+        LOG_TRACE("[DEBUG] %dx%d (K=%d) depth %d: R:%d C:%d score %d, %llu nodes\n",
+                  b.n, b.n, b.k, depth, move.row, move.col, score, (unsigned long long)searchStats.nodes);
+        if (score >= NK_WIN_SCORE / 2 || score <= -NK_WIN_SCORE / 2)
+        {
+            break; // forced result, deeper searches cannot change it
+        }
+    }
+
+    searchCtx->timed = false;
+    return bestMove;
+}
+
+static bool nkTimeUp()
+{
+    if (searchCtx->cancelled)
+    {
+        searchCtx->aborted = true;
+        return true;
+    }
+    if (searchCtx->timed && searchCtx->stopped)
+    {
+        searchCtx->aborted = true; // same as the deadline passing: the last full depth is kept
+        return true;
+    }
+    if (!searchCtx->timed || ++nkNodesSinceCheck < NK_CLOCK_INTERVAL)
+    {
+        return false;
+    }
+    nkNodesSinceCheck = 0;
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    searchCtx->aborted = now.tv_sec > searchCtx->deadline.tv_sec ||
+                    (now.tv_sec == searchCtx->deadline.tv_sec && now.tv_nsec >= searchCtx->deadline.tv_nsec);
+    return searchCtx->aborted;
+}
+
+static void nkPrepareThread()
+{
+    if (nkThreadSearchId != searchCtx->searchId)
+    {
+        memset(nkKillerMoves, ERROR, sizeof(nkKillerMoves));
+        memset(nkHistoryTable, 0, sizeof(nkHistoryTable));
+        nkThreadSearchId = searchCtx->searchId;
+    }
+}
+
+void searchContextInit(struct SearchContext *ctx)
+{
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->mode = searchMode;
+    ctx->depthLimit = searchDepthLimit;
+    ctx->timeBudget = searchTimeBudget;
+    ctx->threads = searchThreads;
+    ctx->mctsPlayouts = mctsPlayouts;
+}
+
+void searchContextRelease(struct SearchContext *ctx)
+{
+    if (ctx->pool != NULL)
+    {
+        poolDestroy(ctx->pool);
+        ctx->pool = NULL;
+    }
+    for (int t = 0; t <= POOL_MAX_THREADS; t++)
+    {
+        free(ctx->nodePools[t]);
+        ctx->nodePools[t] = NULL;
+        ctx->nodePoolSizes[t] = 0;
+    }
+}
+
+struct SearchContext *searchContext()
+{
+    if (searchCtx == NULL || searchCtx == &defaultSearch)
+    {
+        // the globals may have changed since the last call
+        defaultSearch.mode = searchMode;
+        defaultSearch.depthLimit = searchDepthLimit;
+        defaultSearch.timeBudget = searchTimeBudget;
+        defaultSearch.threads = searchThreads;
+        defaultSearch.mctsPlayouts = mctsPlayouts;
+        searchCtx = &defaultSearch;
+    }
+    return searchCtx;
+}
+
+void searchLastStats(struct SearchStats *stats)
+{
+    *stats = searchContext()->stats;
+}
+
+static struct Position searchFinish(int source, struct Position move)
+{
+    searchCtx->stats = *searchStatsEnd(source, move);
+    if (source == STATS_SOURCE_SEARCH)
+    {
+        LOG_DEBUG("[DEBUG] %dx%d (K=%d) search visited %llu nodes\n", searchCtx->stats.n, searchCtx->stats.n,
+                  searchCtx->stats.k, (unsigned long long)searchCtx->stats.nodes);
+    }
+    return move;
+}
+
+struct SearchContext *searchEnter(struct SearchContext *ctx)
+{
+    struct SearchContext *outer = searchCtx;
+    searchCtx = ctx;
+    return outer;
+}
+
+void searchLeave(struct SearchContext *outer)
+{
+    searchCtx = outer;
+}
+
+int searchThreadCount()
+{
+    int threads = searchContext()->threads;
+    threads = (threads > 0) ? threads : poolCoreCount();
+    return (threads > POOL_MAX_THREADS) ? POOL_MAX_THREADS : threads; // so searchWorkers() gets the pool it asks for
+}
+
+struct ThreadPool *searchWorkers()
+{
+    searchContext();
+    int workers = searchThreadCount() - 1;
+    if (searchCtx->pool != NULL && searchCtx->pool->threadCount != workers)
+    {
+        poolDestroy(searchCtx->pool);
+        searchCtx->pool = NULL;
+    }
+    if (searchCtx->pool == NULL && workers > 0)
+    {
+        searchCtx->pool = poolCreate(workers);
+    }
+    return searchCtx->pool;
+}
+
+static int nkSearchRoot(struct NKBoard b, int depth, int firstMove, struct Position *bestMove)
+{
+    int bestVal = -2 * NK_WIN_SCORE;
+    bestMove->row = bestMove->col = ERROR;
+
+    uint64_t key = ttKeyNK(&b, true);
+    int moves[MAX_CELLS];
+    int moveCount = nkOrderMoves(&b, 0, true, moves);
+
+    // Search the previous iteration's best move first
+    for (int m = 1; m < moveCount && firstMove != ERROR; m++)
+    {
+        if (moves[m] == firstMove)
+        {
+            memmove(&moves[1], &moves[0], m * sizeof(moves[0]));
+            moves[0] = firstMove;
+            break;
+        }
+    }
+
+    // without workers, e.g. when no thread could be created, the moves are searched here
+    if (searchThreadCount() > 1 && moveCount > 1 && searchWorkers() != NULL)
+    {
+        return nkSearchRootParallel(b, depth, key, moves, moveCount, bestMove);
+    }
+
+    for (int m = 0; m < moveCount; m++)
+    {
+        struct NKBoard child = b;
+        child.bot |= 1ULL << moves[m];
+        int moveVal = nkAlphaBeta(child, 1, depth - 1, bestVal, 2 * NK_WIN_SCORE, false,
+                                  key ^ ttMoveKeyNK(moves[m], true));
+        if (searchCtx->aborted)
+        {
+            break;
+        }
+        if (moveVal > bestVal)
+        {
+            bestMove->row = moves[m] / b.n;
+            bestMove->col = moves[m] % b.n;
+            bestVal = moveVal;
+        }
+    }
+    return bestVal;
+}
+
+static void nkRootResult(struct NKRootJob *job, int move, int score)
+{
+    pthread_mutex_lock(&job->lock);
+    if (!searchCtx->aborted && score > job->bestVal)
+    {
+        __atomic_store_n(&job->bestVal, score, __ATOMIC_RELAXED);
+        job->bestMove = move;
+    }
+    pthread_mutex_unlock(&job->lock);
+}
+
+static void nkRootTask(void *arg)
+{
+    struct NKRootTask *task = arg;
+    struct NKRootJob *job = task->job;
+    searchCtx = job->ctx; // workers belong to one context, see searchWorkers()
+    nkPrepareThread();
+
+    // count the task alone, the job adds it to the searching thread's statistics
+    struct SearchStats outer = searchStats;
+    memset(&searchStats, 0, sizeof(searchStats));
+
+    // own copy of the board, moves are made on it by value all the way down
+    struct NKBoard child = job->board;
+    child.bot |= 1ULL << task->move;
+    uint64_t key = job->key ^ ttMoveKeyNK(task->move, true);
+    int alpha = __atomic_load_n(&job->bestVal, __ATOMIC_RELAXED);
+
+    if (task->reply == ERROR)
+    {
+        int score = nkAlphaBeta(child, 1, job->depth - 1, alpha, 2 * NK_WIN_SCORE, false, key);
+        nkRootResult(job, task->move, score);
+    }
+    else
+    {
+        // The root move is worth the minimum over its replies. A reply that cannot lower
+        // the running minimum below the shared best is cut off by the window.
+        int *moveVal = &job->moveVals[task->move];
+        int beta = __atomic_load_n(moveVal, __ATOMIC_RELAXED);
+        if (alpha < beta)
+        {
+            child.player |= 1ULL << task->reply;
+            int score = nkAlphaBeta(child, 2, job->depth - 2, alpha, beta, true,
+                                    key ^ ttMoveKeyNK(task->reply, false));
+            int current = beta;
+            while (score < current &&
+                   !__atomic_compare_exchange_n(moveVal, &current, score, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
             {
-                // Check if cell is empty
-                if (board[i][j] == EMPTY)
-                {
-                    // Make the move
-                    board[i][j] = BOT;
-
-                    // compute evaluation function for this
-                    // move.
-                    int moveVal = minimax(board, 0, false);
-                    PRINT_DEBUG("[DEBUG] Depth exited at -> %d\n", depthCounter);
-                    // Undo the move
-                    board[i][j] = EMPTY;
-
-                    // If the value of the current move is more than the best value, then update best move
-                    if (moveVal > bestVal)
-                    {
-                        bestMove.row = i;
-                        bestMove.col = j;
-                        bestVal = moveVal;
-                    }
-                }
             }
         }
-        stopElapseTime("Minimax depth search");
-        writeBestMoveToFile(board, bestMove);
+
+        if (__atomic_sub_fetch(&job->repliesLeft[task->move], 1, __ATOMIC_ACQ_REL) == 0)
+        {
+            nkRootResult(job, task->move, __atomic_load_n(moveVal, __ATOMIC_RELAXED));
+        }
     }
 
-    depthCounter = 0;
-    return bestMove;
+    pthread_mutex_lock(&job->lock);
+    searchStatsAdd(&job->stats, &searchStats);
+    pthread_mutex_unlock(&job->lock);
+    searchStats = outer;
 }
 
-static int minimax(int board[3][3], int depth, bool isMax)
+static int nkSearchRootParallel(struct NKBoard b, int depth, uint64_t key, int moves[MAX_CELLS], int moveCount,
+                                struct Position *bestMove)
 {
-#if DEBUG
-    depthCounter++;
-#endif
-    int score = evaluate(board);
-    // If Maximizer has won the game return his/her
-    // evaluated score
-    if (score == 10)
-        return score;
+    int threads = searchThreadCount();
+    struct NKRootJob job = {.ctx = searchCtx, .board = b, .depth = depth, .key = key, .bestVal = -2 * NK_WIN_SCORE, .bestMove = ERROR};
+    pthread_mutex_init(&job.lock, NULL);
 
-    // If Minimizer has won the game return his/her
-    // evaluated score
-    if (score == -10)
-        return score;
+    // The first (expected best) move is searched alone so the others start with its bound
+    struct NKRootTask first = {&job, moves[0], ERROR};
+    nkRootTask(&first);
 
-    // If there are no more moves and no winner then
-    // it is a tie
-    if (isMovesLeft(board) == false)
+    // With few root moves left, split one ply deeper so every thread gets work
+    bool splitReplies = depth >= 3 && moveCount - 1 < 2 * threads;
+    struct NKRootTask *tasks = malloc(sizeof(struct NKRootTask) * (moveCount - 1) * (splitReplies ? MAX_CELLS : 1));
+    int taskCount = 0;
+
+    for (int m = 1; m < moveCount && tasks != NULL; m++)
+    {
+        struct NKBoard child = b;
+        child.bot |= 1ULL << moves[m];
+        int replies[MAX_CELLS];
+        int replyCount = 0;
+        // a winning or filling root move has no replies to split over
+        if (splitReplies && !nkHasWin(child.bot, b.n, b.k) && nkEmpty(&child) != 0)
+        {
+            replyCount = nkOrderMoves(&child, 1, false, replies);
+        }
+
+        job.moveVals[moves[m]] = 2 * NK_WIN_SCORE;
+        job.repliesLeft[moves[m]] = replyCount;
+        if (replyCount == 0)
+        {
+            tasks[taskCount++] = (struct NKRootTask){&job, moves[m], ERROR};
+        }
+        for (int r = 0; r < replyCount; r++)
+        {
+            tasks[taskCount++] = (struct NKRootTask){&job, moves[m], replies[r]};
+        }
+    }
+
+    if (tasks == NULL)
+    {
+        for (int m = 1; m < moveCount; m++)
+        {
+            struct NKRootTask task = {&job, moves[m], ERROR};
+            nkRootTask(&task);
+        }
+    }
+    for (int t = 0; t < taskCount; t++)
+    {
+        poolSubmit(searchCtx->pool, nkRootTask, &tasks[t]);
+    }
+    poolWait(searchCtx->pool);
+    free(tasks);
+
+    searchStatsAdd(&searchStats, &job.stats);
+    pthread_mutex_destroy(&job.lock);
+
+    bestMove->row = (job.bestMove == ERROR) ? ERROR : job.bestMove / b.n;
+    bestMove->col = (job.bestMove == ERROR) ? ERROR : job.bestMove % b.n;
+    return job.bestVal;
+}
+
+long perftArray(int board[3][3], int depth, bool isMax)
+{
+    if (depth == 0)
+        return 1;
+    if (evaluate(board) != 0 || isMovesLeft(board) == false)
         return 0;
 
-#if !(MINIMAX_GODMODE)
-    if (depth > 2)
+    long nodes = 0;
+    for (int i = 0; i < 3; i++)
+    {
+        for (int j = 0; j < 3; j++)
+        {
+            if (board[i][j] == EMPTY)
+            {
+                board[i][j] = isMax ? BOT : PLAYER1;
+                nodes += perftArray(board, depth - 1, !isMax);
+                board[i][j] = EMPTY;
+            }
+        }
+    }
+    return nodes;
+}
+
+long perftGameState(struct GameState *s, int depth, bool isMax)
+{
+    if (depth == 0)
+        return 1;
+    if (gsWinner(s) != EMPTY || gsIsFull(s))
         return 0;
+
+    long nodes = 0;
+    int who = isMax ? BOT : PLAYER1;
+    for (uint64_t empty = gsEmpty(s); empty;)
+    {
+        int idx = nkPopLowest(&empty);
+        gsMake(s, idx, who);
+        nodes += perftGameState(s, depth - 1, !isMax);
+        gsUnmake(s, idx, who);
+    }
+    return nodes;
+}
+
+long perftBitBoard(struct BitBoard b, int depth, bool isMax)
+{
+    if (depth == 0)
+        return 1;
+    if (bbIsWin(b.bot) || bbIsWin(b.player))
+        return 0;
+
+    long nodes = 0;
+    for (uint16_t empty = bbEmpty(b); empty;)
+    {
+        uint16_t bit = (uint16_t)(1u << bbPopLowest(&empty));
+        struct BitBoard child = isMax ? (struct BitBoard){(uint16_t)(b.bot | bit), b.player}
+                                      : (struct BitBoard){b.bot, (uint16_t)(b.player | bit)};
+        nodes += perftBitBoard(child, depth - 1, !isMax);
+    }
+    return nodes;
+}
+
+long perftNK(struct NKBoard b, int depth, bool isMax)
+{
+    if (depth == 0)
+        return 1;
+    if (nkHasWin(b.bot, b.n, b.k) || nkHasWin(b.player, b.n, b.k))
+        return 0;
+
+    long nodes = 0;
+    for (uint64_t empty = nkEmpty(&b); empty;)
+    {
+        struct NKBoard child = b;
+        if (isMax)
+            child.bot |= 1ULL << nkPopLowest(&empty);
+        else
+            child.player |= 1ULL << nkPopLowest(&empty);
+        nodes += perftNK(child, depth - 1, !isMax);
+    }
+    return nodes;
+}
+
+#if DISABLE_BITBOARD
+static int minimax(struct GameState *s, int depth, bool isMax)
+{
+    STATS_NODE(depth + 1);
+    // The state counts the filled lines, so the winner is a load
+    int winner = gsWinner(s);
+    if (winner == BOT)
+        return STATS_LEAF(10);
+    if (winner == PLAYER1)
+        return STATS_LEAF(-10);
+
+    // If there are no more moves and no winner then
+    // it is a tie
+    if (gsIsFull(s))
+        return STATS_LEAF(0);
+
+    if (searchCtx->depthLimit != NO_DEPTH_LIMIT && depth > searchCtx->depthLimit)
+        return STATS_LEAF(0);
+
+    // Empty cells in row-major order, as the original board scan
+    int best = isMax ? -1000 : 1000;
+    for (uint64_t empty = gsEmpty(s); empty;)
+    {
+        int idx = nkPopLowest(&empty);
+        int who = isMax ? BOT : PLAYER1;
+
+        gsMake(s, idx, who);
+        int score = minimax(s, depth + 1, !isMax);
+        gsUnmake(s, idx, who);
+
+        best = isMax ? max(best, score) : min(best, score);
+    }
+    return best;
+}
+#endif
+
+static int bbMinimax(struct BitBoard b, int depth, bool isMax)
+{
+    STATS_NODE(depth + 1);
+    // Only the side that just moved can have completed a line
+    if (isMax ? bbIsWin(b.player) : bbIsWin(b.bot))
+        return STATS_LEAF(isMax ? -10 : +10);
+
+    uint16_t empty = bbEmpty(b);
+    if (empty == 0)
+        return STATS_LEAF(0);
+
+    if (searchCtx->depthLimit != NO_DEPTH_LIMIT && depth > searchCtx->depthLimit)
+        return STATS_LEAF(0);
+
+#if !(DISABLE_TT)
+    uint64_t key = ttKey(b, isMax);
+    struct TTEntry entry;
+    if (ttProbe(key, TT_DEPTH(depth), &entry) && entry.bound == TT_EXACT)
+    {
+        STATS_COUNT(ttHits);
+        return entry.score;
+    }
+    STATS_COUNT(ttMisses);
+#endif
+
+    int best = isMax ? -1000 : 1000;
+    while (empty)
+    {
+        uint16_t bit = (uint16_t)(1u << bbPopLowest(&empty));
+        if (isMax)
+        {
+            struct BitBoard child = {(uint16_t)(b.bot | bit), b.player};
+            best = max(best, bbMinimax(child, depth + 1, false));
+        }
+        else
+        {
+            struct BitBoard child = {b.bot, (uint16_t)(b.player | bit)};
+            best = min(best, bbMinimax(child, depth + 1, true));
+        }
+    }
+
+#if !(DISABLE_TT)
+    ttStore(key, TT_DEPTH(depth), best, TT_EXACT);
 #endif
+    return best;
+}
+
+static int bbAlphaBeta(struct BitBoard b, int depth, int alpha, int beta, bool isMax)
+{
+    STATS_NODE(depth + 1);
+    if (isMax ? bbIsWin(b.player) : bbIsWin(b.bot))
+        return STATS_LEAF(isMax ? -10 : +10);
 
-    // If this maximizer's move
-    if (isMax)
+    uint16_t empty = bbEmpty(b);
+    if (empty == 0)
+        return STATS_LEAF(0);
+
+    if (searchCtx->depthLimit != NO_DEPTH_LIMIT && depth > searchCtx->depthLimit)
+        return STATS_LEAF(0);
+
+#if !(DISABLE_TT)
+    int alphaOrig = alpha;
+    int betaOrig = beta;
+    uint64_t key = ttKey(b, isMax);
+    struct TTEntry entry;
+    if (ttProbe(key, TT_DEPTH(depth), &entry))
+    {
+        STATS_COUNT(ttHits);
+        if (entry.bound == TT_EXACT)
+            return entry.score;
+        if (entry.bound == TT_LOWER)
+            alpha = max(alpha, entry.score);
+        else
+            beta = min(beta, entry.score);
+        if (alpha >= beta)
+        {
+            STATS_COUNT(cutoffs);
+            return entry.score;
+        }
+    }
+    else
     {
-        int best = -1000;
+        STATS_COUNT(ttMisses);
+    }
+#endif
 
-        // Traverse all cells
-        for (int i = 0; i < 3; i++)
+    int moves[BB_CELLS];
+    int moveCount = bbOrderMoves(b, depth + 1, isMax, moves);
+    int best = isMax ? -1000 : 1000;
+
+    for (int m = 0; m < moveCount; m++)
+    {
+        uint16_t bit = (uint16_t)(1u << moves[m]);
+        if (isMax)
+        {
+            struct BitBoard child = {(uint16_t)(b.bot | bit), b.player};
+            best = max(best, bbAlphaBeta(child, depth + 1, alpha, beta, false));
+            alpha = max(alpha, best);
+        }
+        else
         {
-            for (int j = 0; j < 3; j++)
+            struct BitBoard child = {b.bot, (uint16_t)(b.player | bit)};
+            best = min(best, bbAlphaBeta(child, depth + 1, alpha, beta, true));
+            beta = min(beta, best);
+        }
+
+        if (alpha >= beta)
+        {
+            STATS_COUNT(cutoffs);
+            // Refutation found, remember it for the sibling nodes at this ply
+            int ply = depth + 1;
+            if (killerMoves[ply][0] != moves[m])
             {
-                // Check if cell is empty
-                if (board[i][j] == EMPTY)
-                {
-                    // Make the move
-                    board[i][j] = BOT;
-
-                    // Call minimax recursively and choose
-                    // the maximum value
-                    best = max(best, minimax(board, depth + 1, !isMax));
-
-                    // Undo the move
-                    board[i][j] = EMPTY;
-                }
+                killerMoves[ply][1] = killerMoves[ply][0];
+                killerMoves[ply][0] = moves[m];
             }
+            historyTable[isMax][moves[m]] += (BB_CELLS - depth) * (BB_CELLS - depth);
+            break;
+        }
+    }
+
+#if !(DISABLE_TT)
+    int bound = TT_EXACT;
+    if (best <= alphaOrig)
+        bound = TT_UPPER;
+    else if (best >= betaOrig)
+        bound = TT_LOWER;
+    ttStore(key, TT_DEPTH(depth), best, bound);
+#endif
+    return best;
+}
+
+static int bbOrderMoves(struct BitBoard b, int ply, bool isMax, int moves[BB_CELLS])
+{
+    int scores[BB_CELLS];
+    int count = 0;
+
+    for (uint16_t empty = bbEmpty(b); empty;)
+    {
+        int idx = bbPopLowest(&empty);
+        int score = bbCellPriority[idx] + historyTable[isMax][idx];
+        if (idx == killerMoves[ply][0])
+        {
+            score += KILLER_BONUS;
+        }
+        else if (idx == killerMoves[ply][1])
+        {
+            score += KILLER_BONUS / 2;
+        }
+
+        // insertion sort, highest score first
+        int k = count++;
+        while (k > 0 && scores[k - 1] < score)
+        {
+            scores[k] = scores[k - 1];
+            moves[k] = moves[k - 1];
+            k--;
         }
-        return best;
+        scores[k] = score;
+        moves[k] = idx;
     }
+    return count;
+}
+
+static int nkAlphaBeta(struct NKBoard b, int ply, int depthLeft, int alpha, int beta, bool isMax, uint64_t key)
+{
+    STATS_NODE(ply);
+    if (searchCtx->aborted || nkTimeUp())
+        return 0; // discarded by the caller
+
+    // Only the side that just moved can have completed a line; quicker wins score higher
+    if (isMax ? nkHasWin(b.player, b.n, b.k) : nkHasWin(b.bot, b.n, b.k))
+        return STATS_LEAF(isMax ? -(NK_WIN_SCORE - ply) : NK_WIN_SCORE - ply);
+
+    if (nkEmpty(&b) == 0)
+        return STATS_LEAF(0);
+
+    if (depthLeft == 0)
+        return STATS_LEAF(nkEvaluate(&b));
 
-    // If this minimizer's move
+#if !(DISABLE_TT)
+    int alphaOrig = alpha;
+    int betaOrig = beta;
+    struct TTEntry entry;
+    if (ttProbe(key, depthLeft, &entry))
+    {
+        STATS_COUNT(ttHits);
+        int score = NK_SCORE_FROM_TT(entry.score, ply);
+        if (entry.bound == TT_EXACT)
+            return score;
+        if (entry.bound == TT_LOWER)
+            alpha = max(alpha, score);
+        else
+            beta = min(beta, score);
+        if (alpha >= beta)
+        {
+            STATS_COUNT(cutoffs);
+            return score;
+        }
+    }
     else
     {
-        int best = 1000;
+        STATS_COUNT(ttMisses);
+    }
+#endif
 
-        // Traverse all cells
-        for (int i = 0; i < 3; i++)
+    int moves[MAX_CELLS];
+    int moveCount = nkOrderMoves(&b, ply, isMax, moves);
+    int best = isMax ? -2 * NK_WIN_SCORE : 2 * NK_WIN_SCORE;
+
+    for (int m = 0; m < moveCount; m++)
+    {
+        struct NKBoard child = b;
+        uint64_t childKey = key ^ ttMoveKeyNK(moves[m], isMax);
+        if (isMax)
+        {
+            child.bot |= 1ULL << moves[m];
+            best = max(best, nkAlphaBeta(child, ply + 1, depthLeft - 1, alpha, beta, false, childKey));
+            alpha = max(alpha, best);
+        }
+        else
+        {
+            child.player |= 1ULL << moves[m];
+            best = min(best, nkAlphaBeta(child, ply + 1, depthLeft - 1, alpha, beta, true, childKey));
+            beta = min(beta, best);
+        }
+
+        if (searchCtx->aborted)
+            return 0; // partial result, keep it out of the tables
+
+        if (alpha >= beta)
         {
-            for (int j = 0; j < 3; j++)
+            STATS_COUNT(cutoffs);
+            if (nkKillerMoves[ply][0] != moves[m])
             {
-                // Check if cell is empty
-                if (board[i][j] == EMPTY)
-                {
-                    // Make the move
-                    board[i][j] = PLAYER1;
-
-                    // Call minimax recursively and choose
-                    // the minimum value
-                    best = min(best,
-                               minimax(board, depth + 1, !isMax));
-
-                    // Undo the move
-                    board[i][j] = EMPTY;
-                }
+                nkKillerMoves[ply][1] = nkKillerMoves[ply][0];
+                nkKillerMoves[ply][0] = moves[m];
             }
+            nkHistoryTable[isMax][moves[m]] += depthLeft * depthLeft;
+            break;
         }
-        return best;
     }
+
+#if !(DISABLE_TT)
+    int bound = TT_EXACT;
+    if (best <= alphaOrig)
+        bound = TT_UPPER;
+    else if (best >= betaOrig)
+        bound = TT_LOWER;
+    ttStore(key, depthLeft, NK_SCORE_TO_TT(best, ply), bound);
+#endif
+    return best;
+}
+
+static int nkOrderMoves(const struct NKBoard *b, int ply, bool isMax, int moves[MAX_CELLS])
+{
+    int scores[MAX_CELLS];
+    int count = 0;
+    int n = b->n;
+
+    for (uint64_t cells = nkNeighbours(b); cells;)
+    {
+        int idx = nkPopLowest(&cells);
+        // twice the Manhattan distance to the centre, so even sides have an exact centre
+        int centreDist = abs(2 * (idx / n) - (n - 1)) + abs(2 * (idx % n) - (n - 1));
+        int score = 4 * n - centreDist + nkHistoryTable[isMax][idx];
+        if (idx == nkKillerMoves[ply][0])
+        {
+            score += KILLER_BONUS;
+        }
+        else if (idx == nkKillerMoves[ply][1])
+        {
+            score += KILLER_BONUS / 2;
+        }
+
+        int k = count++;
+        while (k > 0 && scores[k - 1] < score)
+        {
+            scores[k] = scores[k - 1];
+            moves[k] = moves[k - 1];
+            k--;
+        }
+        scores[k] = score;
+        moves[k] = idx;
+    }
+    return count;
 }
 
 static int evaluate(int b[3][3])
@@ -362,115 +1193,3 @@ __asm__(
     return result;
 #endif
 }
-
-static int loadBoardStates(struct BoardState boardStates[])
-{
-    FILE *file = fopen(FILE_BESTMOV, "r");
-    if (file == NULL)
-    {
-        PRINT_DEBUG("%s <- File does not exist. Creating new file.\n", FILE_BESTMOV);
-        FILE *file = fopen(FILE_BESTMOV, "w");
-        PRINT_DEBUG("Text file created.\n");
-        fclose(file);
-        return 0; // No boards loaded
-    }
-    PRINT_DEBUG("File exist. Checking.\n");
-    int count = 0;
-    char line[100];
-    while (fgets(line, sizeof(line), file) != NULL && count < MAX_BOARDS)
-    {
-        // Parse the line
-        char *token = strtok(line, ",");
-        int index = 0;
-
-        // Read the board condition
-        while (token != NULL && index < 9)
-        {
-            if (strcmp(token, "x") == 0)
-            {
-                boardStates[count].board[index / 3][index % 3] = BOT;
-            }
-            else if (strcmp(token, "o") == 0)
-            {
-                boardStates[count].board[index / 3][index % 3] = PLAYER1;
-            }
-            else
-            {
-                boardStates[count].board[index / 3][index % 3] = EMPTY;
-            }
-            token = strtok(NULL, ",");
-            index++;
-        }
-
-        // Read the best move
-        if (token != NULL)
-        {
-            boardStates[count].bestMove.row = atoi(token);
-            token = strtok(NULL, ",");
-            boardStates[count].bestMove.col = atoi(token);
-        }
-        count++;
-    }
-
-    fclose(file);
-    return count; // Return the number of boards loaded
-}
-
-static bool checkAndUpdateBestMove(int board[3][3], struct Position *bestMove, struct BoardState boardStates[], int count)
-{
-    for (int i = 0; i < count; i++)
-    {
-        if (memcmp(board, boardStates[i].board, sizeof(boardStates[i].board)) == 0)
-        {
-            // Board matches, update the best move
-            *bestMove = boardStates[i].bestMove;
-            PRINT_DEBUG("Found position in lookup table\n");
-            PRINT_DEBUG("Best Move = R:%d C:%d\n", bestMove->row, bestMove->col);
-            return bestMove; // Board matches, return the best move
-        }
-    }
-    PRINT_DEBUG("Position not found in lookup table\n");
-    return false; // No matching board found
-}
-
-static void writeBestMoveToFile(int board[3][3], struct Position bestMove)
-{
-    FILE *file = fopen(FILE_BESTMOV, "a"); // Open the file for appending
-    if (file == NULL)
-    {
-        PRINT_DEBUG("Error opening file for writing. -> %s\n", FILE_BESTMOV);
-        return;
-    }
-
-    // Write the board state to the file
-    for (int j = 0; j < 3; j++)
-    {
-        for (int k = 0; k < 3; k++)
-        {
-            if (board[j][k] == PLAYER1)
-            {
-                fprintf(file, "o,");
-                PRINT_DEBUG("o,");
-            }
-            else if (board[j][k] == BOT)
-            {
-                fprintf(file, "x,");
-                PRINT_DEBUG("x,");
-            }
-            else
-            {
-                fprintf(file, "b,");
-                PRINT_DEBUG("b,");
-            }
-        }
-    }
-    // Write the best move to the file
-    fprintf(file, "%d,%d\n", bestMove.row, bestMove.col);
-    if (fprintf(file, "%d,%d\n", bestMove.row, bestMove.col) < 0)
-    {
-        PRINT_DEBUG("Error writing best move to file. -> %s\n", FILE_BESTMOV);
-    }
-    PRINT_DEBUG("\nAttempting to write best move to file: Row = %d, Col = %d\n", bestMove.row, bestMove.col);
-    PRINT_DEBUG("New best move written to file.\n");
-    fclose(file);
-}
\ No newline at end of file
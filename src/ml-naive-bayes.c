@@ -1,23 +1,6 @@
 #include <ml-naive-bayes.h>
 #include <math.h>
 
-int positive_count = 0;
-int negative_count = 0;
-
-int cM[4] = {0, 0, 0, 0};
-int positiveMoveCount[3][3][3];
-int negativeMoveCount[3][3][3];
-
-int test_PredictedErrors = 0;
-int train_PredictedErrors = 0;
-
-int predicted;
-int actual;
-
-double positiveClassProbability;
-double negativeClassProbability;
-double probabilityErrors;
-
 static int assignMoveIndex(char move) //converts char to int value for easier calculation
 {
     switch (move)
@@ -33,13 +16,13 @@ static int assignMoveIndex(char move) //converts char to int value for easier ca
     }
 }
 
-static void calculateProbabilities(int dataset_size)
+static void calculateProbabilities(struct NaiveBayesModel *model, int dataset_size)
 {
     // Calculate class probability
-    positiveClassProbability = (double)positive_count / dataset_size;
-    negativeClassProbability = (double)negative_count / dataset_size;
-    PRINT_DEBUG("Positive Class Probability: %lf\n", positiveClassProbability);
-    PRINT_DEBUG("Negative Class Probability: %lf\n", negativeClassProbability);
+    model->positiveClassProbability = (double)model->positive_count / dataset_size;
+    model->negativeClassProbability = (double)model->negative_count / dataset_size;
+    LOG_INFO("Positive Class Probability: %lf\n", model->positiveClassProbability);
+    LOG_INFO("Negative Class Probability: %lf\n", model->negativeClassProbability);
 
     // Calculate conditional probability with laplace smoothing
     int laplace_smoothing = 1;
@@ -63,32 +46,32 @@ static void calculateProbabilities(int dataset_size)
                     move = 'b';
                 }
 
-                double positiveProbability = (double)(positiveMoveCount[row][col][moveIndex] + laplace_smoothing) / (positive_count + 3 * laplace_smoothing);
-                double negativeProbability = (double)(negativeMoveCount[row][col][moveIndex] + laplace_smoothing) / (negative_count + 3 * laplace_smoothing);
-                if (positive_count == 0)
+                double positiveProbability = (double)(model->positiveMoveCount[row][col][moveIndex] + laplace_smoothing) / (model->positive_count + 3 * laplace_smoothing);
+                double negativeProbability = (double)(model->negativeMoveCount[row][col][moveIndex] + laplace_smoothing) / (model->negative_count + 3 * laplace_smoothing);
+                if (model->positive_count == 0)
                 {
-                    PRINT_DEBUG("Probability of %c (positive) at grid(%d,%d): No positive outcomes\n", move, row, col);
-                    PRINT_DEBUG("Probability of %c (negative) at grid(%d,%d): %lf\n", move, row, col, negativeProbability);
+                    LOG_TRACE("Probability of %c (positive) at grid(%d,%d): No positive outcomes\n", move, row, col);
+                    LOG_TRACE("Probability of %c (negative) at grid(%d,%d): %lf\n", move, row, col, negativeProbability);
                 }
-                else if (negative_count == 0)
+                else if (model->negative_count == 0)
                 {
-                    PRINT_DEBUG("Probability of %c (positive) at grid(%d,%d): %lf\n", move, row, col, positiveProbability);
-                    PRINT_DEBUG("Probability of %c (negative) at grid(%d,%d): No negative outcomes\n", move, row, col);
+                    LOG_TRACE("Probability of %c (positive) at grid(%d,%d): %lf\n", move, row, col, positiveProbability);
+                    LOG_TRACE("Probability of %c (negative) at grid(%d,%d): No negative outcomes\n", move, row, col);
                 }
                 else
                 {
-                    PRINT_DEBUG("Probability of %c (positive) at grid(%d,%d): %lf\n", move, row, col, positiveProbability);
-                    PRINT_DEBUG("Probability of %c (negative) at grid(%d,%d): %lf\n", move, row, col, negativeProbability);
+                    LOG_TRACE("Probability of %c (positive) at grid(%d,%d): %lf\n", move, row, col, positiveProbability);
+                    LOG_TRACE("Probability of %c (negative) at grid(%d,%d): %lf\n", move, row, col, negativeProbability);
                 }
             }
         }
     }
 }
 
-static int predictOutcome(struct Dataset board)
+static int predictOutcome(const struct NaiveBayesModel *model, struct Dataset board)
 {
-    double positiveProbability = positiveClassProbability;
-    double negativeProbability = negativeClassProbability;
+    double positiveProbability = model->positiveClassProbability;
+    double negativeProbability = model->negativeClassProbability;
 
     // required as 0*anything = 0
     if (positiveProbability == 0)
@@ -108,15 +91,15 @@ static int predictOutcome(struct Dataset board)
             int moveIndex = assignMoveIndex(board.grid[row][col]);
             if (moveIndex != -1)
             {
-                // PRINT_DEBUG("\nPC_%d, NC_%d, pMC_%d, nMC_%d",positive_count,negative_count,positiveMoveCount[row][col][moveIndex],negativeMoveCount[row][col][moveIndex]);
-                if (positive_count > 0)
+                // LOG_DEBUG("\nPC_%d, NC_%d, pMC_%d, nMC_%d",model->positive_count,model->negative_count,model->positiveMoveCount[row][col][moveIndex],model->negativeMoveCount[row][col][moveIndex]);
+                if (model->positive_count > 0)
                 {
-                    positiveProbability *= (double)positiveMoveCount[row][col][moveIndex] / (double)positive_count;
+                    positiveProbability *= (double)model->positiveMoveCount[row][col][moveIndex] / (double)model->positive_count;
                 }
 
-                if (negative_count > 0)
+                if (model->negative_count > 0)
                 {
-                    negativeProbability *= (double)negativeMoveCount[row][col][moveIndex] / (double)negative_count;
+                    negativeProbability *= (double)model->negativeMoveCount[row][col][moveIndex] / (double)model->negative_count;
                 }
             }
         }
@@ -133,27 +116,27 @@ static int predictOutcome(struct Dataset board)
     }
 
     // Output probabilities for debugging
-    // PRINT_DEBUG("\nPositive: %lf, Negative: %lf Probability: \n", positiveProbability, negativeProbability);
+    // LOG_DEBUG("\nPositive: %lf, Negative: %lf Probability: \n", positiveProbability, negativeProbability);
 
     //returns a value based on condition
     if (positiveProbability > negativeProbability)
     {
-        // PRINT_DEBUG("Predicted Outcome: Positive\n");
+        // LOG_DEBUG("Predicted Outcome: Positive\n");
         return 1;
     }
     else if (positiveProbability == 0 || negativeProbability == 0)
     {
-        // PRINT_DEBUG("Unable to predict outcome based on available data.");
+        // LOG_DEBUG("Unable to predict outcome based on available data.");
         return -1;
     }
     else
     {
-        // PRINT_DEBUG("Predicted Outcome: Negative\n");
+        // LOG_DEBUG("Predicted Outcome: Negative\n");
         return 0;
     }
 }
 
-struct Position getBestPosition(int grid[3][3], char player)
+struct Position getBestPosition(const struct NaiveBayesModel *model, int grid[3][3], char player)
 {
     // Determine whether bot is X or O depending on current player
     char bot = (player == 'x' ? 'o' : 'x');
@@ -163,19 +146,19 @@ struct Position getBestPosition(int grid[3][3], char player)
     double highestProbability = 0.0;
 
     int bot_count;
-    int(*botMoveCount)[3][3];
+    const int(*botMoveCount)[3][3];
 
     // Use positive or negative count for calculating probability depending on whether bot is X or O
     // Note that for the dataset, negative outcome is for X, meaning the position of O in negative outcomes are good for the bot playing as O
     if (bot == 'x')
     {
-        bot_count = positive_count;
-        botMoveCount = positiveMoveCount;
+        bot_count = model->positive_count;
+        botMoveCount = model->positiveMoveCount;
     }
     else
     {
-        bot_count = negative_count;
-        botMoveCount = negativeMoveCount;
+        bot_count = model->negative_count;
+        botMoveCount = model->negativeMoveCount;
     }
 
     for (int row = 0; row < 3; row++)
@@ -234,55 +217,55 @@ struct Position getBestPosition(int grid[3][3], char player)
     if (bestRow != ERROR && bestCol != ERROR)
     {
         grid[bestRow][bestCol] = bestMove;
-        PRINT_DEBUG("Best move: %c at grid (%d, %d) with probability: %lf\n", bestMove, bestRow, bestCol, highestProbability);
+        LOG_DEBUG("Best move: %c at grid (%d, %d) with probability: %lf\n", bestMove, bestRow, bestCol, highestProbability);
         return (struct Position){bestRow, bestCol};
     }
     else
     {
-        PRINT_DEBUG("\nNo valid move found.\n");
+        LOG_DEBUG("\nNo valid move found.\n");
         return (struct Position){ERROR, ERROR}; // Indicate no valid move found
     }
 }
 
-static void resetTrainingData() {
+static void resetTrainingData(struct NaiveBayesModel *model) {
     // Reset outcome counts
-    positive_count = 0;
-    negative_count = 0;
+    model->positive_count = 0;
+    model->negative_count = 0;
 
     // Reset move count arrays for each grid position
     for (int row = 0; row < 3; row++) {
         for (int col = 0; col < 3; col++) {
             for (int moveIndex = 0; moveIndex < 3; moveIndex++) {
-                positiveMoveCount[row][col][moveIndex] = 0;
-                negativeMoveCount[row][col][moveIndex] = 0;
+                model->positiveMoveCount[row][col][moveIndex] = 0;
+                model->negativeMoveCount[row][col][moveIndex] = 0;
             }
         }
     }
 
     // Reset the confusion matrix counters
-    cM[0] = 0; // True positive
-    cM[1] = 0; // False negative
-    cM[2] = 0; // False positive
-    cM[3] = 0; // True negative
+    model->cM[0] = 0; // True positive
+    model->cM[1] = 0; // False negative
+    model->cM[2] = 0; // False positive
+    model->cM[3] = 0; // True negative
 
     // Reset prediction errors
-    test_PredictedErrors = 0;
-    train_PredictedErrors = 0;
+    model->test_PredictedErrors = 0;
+    model->train_PredictedErrors = 0;
 }
 
-int initData()
+int initData(struct NaiveBayesModel *model)
 {
-    resetTrainingData();
+    resetTrainingData(model);
     int retVal = SUCCESS;
+    bool doOnce = false;
+    struct Dataset trainingData[DATA_SIZE]; // the training, testing and whole datasets in turn
 
 doGetTrainingData:
-    static bool doOnce = false;
-    struct Dataset *trainingData = NULL;      // Initialize pointer
-    int len = getTrainingData(&trainingData); // Pass address of pointer
+    int len = getTrainingData(trainingData);
 
     if (len <= 0)
     {
-        retVal = readDataset(RES_PATH "" DATA_PATH, true);
+        retVal = readDataset(RES_PATH "" DATA_PATH, true, trainingData);
         if (retVal != SUCCESS)
         {
             return retVal;
@@ -303,7 +286,7 @@ doGetTrainingData:
         // Get outcome class count for each position
         if (strcmp(trainingData[i].outcome, "positive") == 0)
         {
-            positive_count++;
+            model->positive_count++;
             for (int row = 0; row < 3; row++)
             {
                 for (int col = 0; col < 3; col++)
@@ -311,14 +294,14 @@ doGetTrainingData:
                     int moveIndex = assignMoveIndex(trainingData[i].grid[row][col]);
                     if (moveIndex != -1)
                     {
-                        positiveMoveCount[row][col][moveIndex]++;
+                        model->positiveMoveCount[row][col][moveIndex]++;
                     }
                 }
             }
         }
         else if (strcmp(trainingData[i].outcome, "negative") == 0)
         {
-            negative_count++;
+            model->negative_count++;
             for (int row = 0; row < 3; row++)
             {
                 for (int col = 0; col < 3; col++)
@@ -326,81 +309,80 @@ doGetTrainingData:
                     int moveIndex = assignMoveIndex(trainingData[i].grid[row][col]);
                     if (moveIndex != -1)
                     {
-                        negativeMoveCount[row][col][moveIndex]++;
+                        model->negativeMoveCount[row][col][moveIndex]++;
                     }
                 }
             }
         }
     }
-    calcTrainErrors();
-    calcConfusionMatrix();
+    calcTrainErrors(model, trainingData);
+    calcConfusionMatrix(model, trainingData);
     return SUCCESS;
 }
 
-static void assignCMValue(int actual, int predicted)
+static void assignCMValue(struct NaiveBayesModel *model, int actual, int predicted)
 {
-    // PRINT_DEBUG("\nactual_%i, predicted_%i\n",actual,predicted);
+    // LOG_DEBUG("\nactual_%i, predicted_%i\n",actual,predicted);
 
     if (actual == ERROR || predicted == ERROR)
     {
-        PRINT_DEBUG("ERROR either value is -1. actual: %d predicted: %d", actual, predicted);
+        LOG_ERROR("ERROR either value is -1. actual: %d predicted: %d", actual, predicted);
     }
 
     if (actual == 1)
     {
         if (predicted == 1)
         {
-            cM[0] += 1; // True positive
+            model->cM[0] += 1; // True positive
         }
         else
         {
-            cM[1] += 1; // False negative
+            model->cM[1] += 1; // False negative
         }
     }
     else
     {
         if (predicted == 1)
         {
-            cM[2] += 1; // False positive
+            model->cM[2] += 1; // False positive
         }
         else
         {
-            cM[3] += 1; // True negative
+            model->cM[3] += 1; // True negative
         }
     }
 }
 
-static void calcConfusionMatrix()
+static void calcConfusionMatrix(struct NaiveBayesModel *model, struct Dataset test[DATA_SIZE])
 {
     //Tests ml on test dataset and stores result in a confusion matrix
 
-    struct Dataset *test = NULL;
-    int len = getTestingData(&test);
-    // PRINT_DEBUG("Test_Data length: %d\n", len);
+    int len = getTestingData(test);
+    // LOG_DEBUG("Test_Data length: %d\n", len);
     //loops through testing dataset
     if (len > 0)
     { // Ensure len is valid before accessing test
         for (int i = 0; i < len; i++)
         {
-            actual = getTruthValue(test[i].outcome); //converts char* to int for comparison
-            predicted = predictOutcome(test[i]);
+            int actual = getTruthValue(test[i].outcome); //converts char* to int for comparison
+            int predicted = predictOutcome(model, test[i]);
 
             // checks and updates total errors for test dataset
             if (actual != predicted)
             {
-                test_PredictedErrors += 1;
+                model->test_PredictedErrors += 1;
             }
 
             //sets value based on actual vs predicted
-            assignCMValue(actual, predicted);
+            assignCMValue(model, actual, predicted);
         }
     }
 
     double i = TESTING_DATA_SIZE;                       // assign macro to double as you cant cast macros
-    probabilityErrors = (1 / i) * test_PredictedErrors; // round to 2dp? not in spec though
+    model->probabilityErrors = (1 / i) * model->test_PredictedErrors; // round to 2dp? not in spec though
 
-    PRINT_DEBUG("For testing dataset: %d errors, %lf probability of error.\n", test_PredictedErrors, probabilityErrors);
-    PRINT_DEBUG("TP: %d, FN: %d, FP: %d, TN: %d\n", cM[0], cM[1], cM[2], cM[3]);
+    LOG_INFO("For testing dataset: %d errors, %lf probability of error.\n", model->test_PredictedErrors, model->probabilityErrors);
+    LOG_INFO("TP: %d, FN: %d, FP: %d, TN: %d\n", model->cM[0], model->cM[1], model->cM[2], model->cM[3]);
 }
 
 int getTruthValue(char *str1) //returns an integer value based on input
@@ -416,54 +398,53 @@ int getTruthValue(char *str1) //returns an integer value based on input
     else
     {
         //guard case if inputs are neither "positive" nor "negative"
-        PRINT_DEBUG("ERROR: Not truth value: %p", str1);
+        LOG_ERROR("ERROR: Not truth value: %p", str1);
         return -1;
     }
 }
 
-static void calcTrainErrors()
+static void calcTrainErrors(struct NaiveBayesModel *model, struct Dataset train[DATA_SIZE])
 {
-    struct Dataset *train = NULL;      // Initialize pointer
-    int len = getTrainingData(&train); // Pass address of pointer
+    int len = getTrainingData(train);
     // debugDataset(test,len);
 
     if (len > 0)
     { // Ensure len is valid before accessing test
         for (int i = 0; i < len; i++)
         {
-            predicted = predictOutcome(train[i]);
-            actual = getTruthValue(train[i].outcome);
-            // PRINT_DEBUG("Actual dataset outcome: %s, Dataset outcome: %d, Predicted outcome: %d\n", test[i].outcome, actual, predicted);
+            int predicted = predictOutcome(model, train[i]);
+            int actual = getTruthValue(train[i].outcome);
+            // LOG_DEBUG("Actual dataset outcome: %s, Dataset outcome: %d, Predicted outcome: %d\n", test[i].outcome, actual, predicted);
             // checks and updates total errors for train dataset
             if (actual != predicted)
             {
-                train_PredictedErrors += 1;
+                model->train_PredictedErrors += 1;
             }
         }
     }
 
     double i = TRAINING_DATA_SIZE;                       // assign macro to double var as macros cant be cast
-    probabilityErrors = (1 / i) * train_PredictedErrors; // round to 2dp? not in spec though
+    model->probabilityErrors = (1 / i) * model->train_PredictedErrors; // round to 2dp? not in spec though
 
-    PRINT_DEBUG("\nFor training dataset: %d errors, %lf probability of error.\n", train_PredictedErrors, probabilityErrors);
+    LOG_INFO("\nFor training dataset: %d errors, %lf probability of error.\n", model->train_PredictedErrors, model->probabilityErrors);
 }
 
 static void debugDataset(struct Dataset *data, int len)
 {
-    PRINT_DEBUG("%d\n", len);
+    LOG_DEBUG("%d\n", len);
     if (len > 0)
     { // Ensure len is valid before accessing test
         for (int i = 0; i < len; i++)
         {
-            PRINT_DEBUG("%d ", i);
+            LOG_DEBUG("%d ", i);
             for (int j = 0; j < 3; j++)
             {
                 for (int k = 0; k < 3; k++)
                 {
-                    PRINT_DEBUG("%c,", data->grid[j][k]);
+                    LOG_DEBUG("%c,", data->grid[j][k]);
                 }
             }
-            PRINT_DEBUG("%s\n", data->outcome);
+            LOG_DEBUG("%s\n", data->outcome);
         }
     }
 }
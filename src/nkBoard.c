@@ -0,0 +1,143 @@
+#include <nkBoard.h>
+
+uint64_t nkStartMasks[MAX_N + 1][MAX_N + 1][NK_DIRECTIONS];
+uint8_t nkCellWindows[MAX_N + 1][MAX_N + 1][MAX_CELLS][MAX_CELL_WINDOWS];
+uint8_t nkCellWindowCount[MAX_N + 1][MAX_N + 1][MAX_CELLS];
+
+static uint64_t nkWindowMasks[MAX_N + 1][MAX_N + 1][MAX_LINES];
+static int nkWindowCount[MAX_N + 1][MAX_N + 1];
+static uint64_t nkNotLeftCol[MAX_N + 1];  /**< All cells except column 0 */
+static uint64_t nkNotRightCol[MAX_N + 1]; /**< All cells except column n-1 */
+
+static const int pow3[MAX_N + 1] = {0, 1, 3, 9, 27, 81, 243, 729, 2187};
+
+__attribute__((constructor)) static void nkInitTables()
+{
+    for (int n = MIN_N; n <= MAX_N; n++)
+    {
+        nkNotLeftCol[n] = nkNotRightCol[n] = nkFull(n);
+        for (int row = 0; row < n; row++)
+        {
+            nkNotLeftCol[n] &= ~NK_BIT(n, row, 0);
+            nkNotRightCol[n] &= ~NK_BIT(n, row, n - 1);
+        }
+
+        for (int k = 3; k <= n; k++)
+        {
+            // {row step, col step} of right, down, down-right, down-left
+            const int dirs[NK_DIRECTIONS][2] = {{0, 1}, {1, 0}, {1, 1}, {1, -1}};
+            for (int d = 0; d < NK_DIRECTIONS; d++)
+            {
+                uint64_t starts = 0;
+                for (int row = 0; row < n; row++)
+                {
+                    for (int col = 0; col < n; col++)
+                    {
+                        int endRow = row + (k - 1) * dirs[d][0];
+                        int endCol = col + (k - 1) * dirs[d][1];
+                        if (endRow >= n || endCol < 0 || endCol >= n)
+                        {
+                            continue;
+                        }
+
+                        starts |= NK_BIT(n, row, col);
+                        int windowIdx = nkWindowCount[n][k]++;
+                        uint64_t window = 0;
+                        for (int i = 0; i < k; i++)
+                        {
+                            int cell = (row + i * dirs[d][0]) * n + col + i * dirs[d][1];
+                            window |= 1ULL << cell;
+                            nkCellWindows[n][k][cell][nkCellWindowCount[n][k][cell]++] = (uint8_t)windowIdx;
+                        }
+                        nkWindowMasks[n][k][windowIdx] = window;
+                    }
+                }
+                nkStartMasks[n][k][d] = starts;
+            }
+        }
+    }
+}
+
+bool nkIsValidSize(int n, int k)
+{
+    return n >= MIN_N && n <= MAX_N && k >= 3 && k <= n;
+}
+
+struct NKBoard nkFromGrid(int grid[MAX_N][MAX_N], int n, int k)
+{
+    struct NKBoard b = {0, 0, n, k};
+    for (int i = 0; i < n; i++)
+    {
+        for (int j = 0; j < n; j++)
+        {
+            if (grid[i][j] == BOT)
+            {
+                b.bot |= NK_BIT(n, i, j);
+            }
+            else if (grid[i][j] == PLAYER1)
+            {
+                b.player |= NK_BIT(n, i, j);
+            }
+        }
+    }
+    return b;
+}
+
+uint64_t nkWinLine(uint64_t mask, int n, int k)
+{
+    for (int i = 0; i < nkWindowCount[n][k]; i++)
+    {
+        if ((mask & nkWindowMasks[n][k][i]) == nkWindowMasks[n][k][i])
+        {
+            return nkWindowMasks[n][k][i];
+        }
+    }
+    return 0;
+}
+
+const uint64_t *nkWindows(int n, int k, int *count)
+{
+    *count = nkWindowCount[n][k];
+    return nkWindowMasks[n][k];
+}
+
+uint64_t nkNeighbours(const struct NKBoard *b)
+{
+    int n = b->n;
+    uint64_t stones = b->bot | b->player;
+    if (stones == 0)
+    {
+        return NK_BIT(n, n / 2, n / 2);
+    }
+
+    // spread sideways first, then up and down, so diagonals are covered too
+    uint64_t rows = stones | ((stones << 1) & nkNotLeftCol[n]) | ((stones >> 1) & nkNotRightCol[n]);
+    uint64_t area = rows | (rows << n) | (rows >> n);
+    return area & nkEmpty(b);
+}
+
+int nkEvaluate(const struct NKBoard *b)
+{
+    int count;
+    const uint64_t *windows = nkWindows(b->n, b->k, &count);
+    int score = 0;
+
+    for (int i = 0; i < count; i++)
+    {
+        int bots = __builtin_popcountll(b->bot & windows[i]);
+        int players = __builtin_popcountll(b->player & windows[i]);
+        if (players == 0)
+        {
+            score += pow3[bots];
+        }
+        else if (bots == 0)
+        {
+            score -= pow3[players];
+        }
+    }
+    if (score > NK_WIN_SCORE / 2)
+    {
+        return NK_WIN_SCORE / 2;
+    }
+    return (score < -NK_WIN_SCORE / 2) ? -NK_WIN_SCORE / 2 : score;
+}
@@ -0,0 +1,264 @@
+#include <profiler.h>
+#include <logger.h>
+#include <pthread.h>
+
+/**
+ * @struct ProfileThread
+ * @brief Statistics written by one thread, kept after it exits for the dump.
+ *
+ * A block whose thread exited is handed to the next thread that closes its first span,
+ * which adds to the same statistics, so a process starting a thread per move keeps as
+ * many blocks as it ever ran threads at once.
+ */
+struct ProfileThread
+{
+    struct ProfileStats stats[PROFILE_MAX_LABELS];
+    bool inUse;                  /**< Whether a running thread writes the block, guarded by `profileLock` */
+    struct ProfileThread *next;
+};
+
+/**
+ * @struct ProfileSpan
+ * @brief An open span of a thread's stack.
+ */
+struct ProfileSpan
+{
+    int id;
+    uint64_t startNs;
+};
+
+static const char *labels[PROFILE_MAX_LABELS];
+static int labelCount = 0;
+static struct ProfileThread *threads = NULL; /**< Every block, blocks of exited threads included */
+static pthread_mutex_t profileLock = PTHREAD_MUTEX_INITIALIZER; /**< Guards `labels` and `threads` */
+static pthread_once_t profileOnce = PTHREAD_ONCE_INIT;
+static pthread_key_t threadKey;        /**< Hands a thread's block back when it exits */
+
+static __thread struct ProfileThread *thread = NULL;
+static __thread struct ProfileSpan stack[PROFILE_MAX_DEPTH];
+static __thread int depth = 0;
+
+static uint64_t nowNs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void dumpAtExit()
+{
+    logFlush(); // what was logged before exit comes first
+    profileDump(stderr);
+}
+
+int profileLabel(const char *label)
+{
+    pthread_mutex_lock(&profileLock);
+    int id = ERROR;
+    for (int i = 0; i < labelCount && id == ERROR; i++)
+    {
+        id = (strcmp(labels[i], label) == 0) ? i : ERROR;
+    }
+    if (id == ERROR && labelCount < PROFILE_MAX_LABELS)
+    {
+        if (labelCount == 0)
+        {
+            atexit(dumpAtExit);
+        }
+        id = labelCount;
+        labels[id] = label;
+        __atomic_store_n(&labelCount, labelCount + 1, __ATOMIC_RELEASE);
+    }
+    pthread_mutex_unlock(&profileLock);
+    return id;
+}
+
+void profileBegin(int id)
+{
+    if (depth < PROFILE_MAX_DEPTH)
+    {
+        stack[depth].id = id;
+        stack[depth].startNs = nowNs();
+    }
+    depth++;
+}
+
+int profileBucket(uint64_t ns)
+{
+    if (ns < 4)
+    {
+        return (int)ns;
+    }
+    int log2 = 63 - __builtin_clzll(ns);
+    int bucket = 4 * log2 + (int)((ns >> (log2 - 2)) & 3); // the two bits below the top one
+    return (bucket < PROFILE_BUCKETS) ? bucket : PROFILE_BUCKETS - 1;
+}
+
+// Lowest duration of a bucket
+static uint64_t bucketStart(int bucket)
+{
+    if (bucket < 4)
+    {
+        return (uint64_t)bucket;
+    }
+    return (uint64_t)(4 + (bucket & 3)) << (bucket / 4 - 2);
+}
+
+static void releaseThread(void *arg)
+{
+    struct ProfileThread *t = arg;
+    pthread_mutex_lock(&profileLock);
+    t->inUse = false;
+    pthread_mutex_unlock(&profileLock);
+}
+
+static void createThreadKey()
+{
+    pthread_key_create(&threadKey, releaseThread);
+}
+
+// Gives the calling thread a block, one of an exited thread if there is one
+static struct ProfileThread *claimThread()
+{
+    pthread_once(&profileOnce, createThreadKey);
+    pthread_mutex_lock(&profileLock);
+    struct ProfileThread *t = threads;
+    while (t != NULL && t->inUse)
+    {
+        t = t->next;
+    }
+    if (t == NULL && (t = calloc(1, sizeof(struct ProfileThread))) != NULL)
+    {
+        t->next = threads;
+        threads = t;
+    }
+    if (t != NULL)
+    {
+        t->inUse = true;
+        pthread_setspecific(threadKey, t);
+    }
+    pthread_mutex_unlock(&profileLock);
+    return t;
+}
+
+void profileEnd()
+{
+    if (depth == 0)
+    {
+        return; // more ends than begins
+    }
+    depth--;
+    if (depth >= PROFILE_MAX_DEPTH || stack[depth].id == ERROR)
+    {
+        return;
+    }
+
+    uint64_t ns = nowNs() - stack[depth].startNs;
+    if (thread == NULL && (thread = claimThread()) == NULL)
+    {
+        return;
+    }
+
+    struct ProfileStats *s = &thread->stats[stack[depth].id];
+    s->minNs = (s->count == 0 || ns < s->minNs) ? ns : s->minNs;
+    s->maxNs = (ns > s->maxNs) ? ns : s->maxNs;
+    s->totalNs += ns;
+    s->buckets[profileBucket(ns)]++;
+    s->count++;
+}
+
+void profileEndScope(int *scope)
+{
+    (void)scope;
+    profileEnd();
+}
+
+// Sums one label over all threads; profileLock held
+static void sumStats(int id, struct ProfileStats *sum)
+{
+    memset(sum, 0, sizeof(*sum));
+    for (struct ProfileThread *t = threads; t != NULL; t = t->next)
+    {
+        const struct ProfileStats *s = &t->stats[id];
+        if (s->count == 0)
+        {
+            continue;
+        }
+        sum->minNs = (sum->count == 0 || s->minNs < sum->minNs) ? s->minNs : sum->minNs;
+        sum->maxNs = (s->maxNs > sum->maxNs) ? s->maxNs : sum->maxNs;
+        sum->count += s->count;
+        sum->totalNs += s->totalNs;
+        for (int b = 0; b < PROFILE_BUCKETS; b++)
+        {
+            sum->buckets[b] += s->buckets[b];
+        }
+    }
+}
+
+// Duration below which a fraction of the spans fall, clamped to the exact min and max
+static uint64_t percentile(const struct ProfileStats *s, double fraction)
+{
+    uint64_t rank = (uint64_t)(fraction * (double)(s->count - 1)), seen = 0;
+    for (int b = 0; b < PROFILE_BUCKETS; b++)
+    {
+        seen += s->buckets[b];
+        if (seen > rank)
+        {
+            uint64_t ns = bucketStart(b + 1);
+            return (ns < s->minNs) ? s->minNs : (ns > s->maxNs) ? s->maxNs : ns;
+        }
+    }
+    return s->maxNs;
+}
+
+bool profileStats(const char *label, struct ProfileStats *stats)
+{
+    memset(stats, 0, sizeof(*stats));
+    pthread_mutex_lock(&profileLock);
+    bool isFound = false;
+    for (int id = 0; id < labelCount && !isFound; id++)
+    {
+        if (strcmp(labels[id], label) == 0)
+        {
+            sumStats(id, stats);
+            isFound = true;
+        }
+    }
+    pthread_mutex_unlock(&profileLock);
+    return isFound;
+}
+
+void profileDump(FILE *file)
+{
+    pthread_mutex_lock(&profileLock);
+    bool isHeaderPrinted = false;
+    for (int id = 0; id < labelCount; id++)
+    {
+        struct ProfileStats s;
+        sumStats(id, &s);
+        if (s.count == 0)
+        {
+            continue;
+        }
+        if (!isHeaderPrinted)
+        {
+            fprintf(file, "[PROFILE] %-32s %10s %12s %11s %11s %11s %11s %11s %11s\n", "label", "count", "total ms",
+                    "mean us", "min us", "p50 us", "p90 us", "p99 us", "max us");
+            isHeaderPrinted = true;
+        }
+        fprintf(file, "[PROFILE] %-32s %10llu %12.3f %11.3f %11.3f %11.3f %11.3f %11.3f %11.3f\n", labels[id],
+                (unsigned long long)s.count, s.totalNs / 1e6, s.totalNs / 1e3 / s.count, s.minNs / 1e3,
+                percentile(&s, 0.50) / 1e3, percentile(&s, 0.90) / 1e3, percentile(&s, 0.99) / 1e3, s.maxNs / 1e3);
+    }
+    pthread_mutex_unlock(&profileLock);
+}
+
+void profileReset()
+{
+    pthread_mutex_lock(&profileLock);
+    for (struct ProfileThread *t = threads; t != NULL; t = t->next)
+    {
+        memset(t->stats, 0, sizeof(t->stats));
+    }
+    pthread_mutex_unlock(&profileLock);
+}
@@ -0,0 +1,120 @@
+#include <searchStats.h>
+#include <math.h>
+
+__thread struct SearchStats searchStats;
+FILE *searchStatsLog = NULL;
+
+static __thread struct timespec statsStart;
+
+static const char *sourceNames[] = {"none", "movetable", "gamedb", "lookup", "search"};
+
+void searchStatsBegin(int n, int k)
+{
+    memset(&searchStats, 0, sizeof(searchStats));
+    searchStats.n = n;
+    searchStats.k = k;
+    searchStats.move.row = searchStats.move.col = ERROR;
+    clock_gettime(CLOCK_MONOTONIC, &statsStart);
+}
+
+const struct SearchStats *searchStatsEnd(int source, struct Position move)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    searchStats.wallNs = (uint64_t)(now.tv_sec - statsStart.tv_sec) * 1000000000ULL + now.tv_nsec - statsStart.tv_nsec;
+    searchStats.source = source;
+    searchStats.move = move;
+
+    if (searchStatsLog != NULL)
+    {
+        searchStatsJson(&searchStats, searchStatsLog);
+    }
+    return &searchStats;
+}
+
+void searchStatsAdd(struct SearchStats *to, const struct SearchStats *from)
+{
+    to->nodes += from->nodes;
+    to->leaves += from->leaves;
+    to->cutoffs += from->cutoffs;
+    to->ttHits += from->ttHits;
+    to->ttMisses += from->ttMisses;
+    to->lookupHits += from->lookupHits;
+    to->lookupMisses += from->lookupMisses;
+    for (int ply = 0; ply < STATS_MAX_PLY; ply++)
+    {
+        to->plyNodes[ply] += from->plyNodes[ply];
+    }
+}
+
+int searchStatsDepth(const struct SearchStats *stats)
+{
+    int depth = STATS_MAX_PLY - 1;
+    while (depth > 0 && stats->plyNodes[depth] == 0)
+    {
+        depth--;
+    }
+    return depth;
+}
+
+// Nodes of a uniform tree of branching b, d plies deep
+static double treeNodes(double b, int d)
+{
+    double nodes = 0, level = 1;
+    for (int ply = 1; ply <= d; ply++)
+    {
+        level *= b;
+        nodes += level;
+    }
+    return nodes;
+}
+
+double searchStatsBranching(const struct SearchStats *stats)
+{
+    int depth = searchStatsDepth(stats);
+    if (depth == 0)
+    {
+        return 0;
+    }
+
+    // b + ... + b^d grows with b, and b = nodes is always enough
+    double lo = 0, hi = (double)stats->nodes;
+    for (int it = 0; it < 64; it++)
+    {
+        double mid = (lo + hi) / 2;
+        if (treeNodes(mid, depth) < (double)stats->nodes)
+        {
+            lo = mid;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    return (lo + hi) / 2;
+}
+
+void searchStatsJson(const struct SearchStats *stats, FILE *file)
+{
+    int depth = searchStatsDepth(stats);
+    int source = (stats->source >= 0 && stats->source <= STATS_SOURCE_SEARCH) ? stats->source : STATS_SOURCE_NONE;
+
+    // one line per call even when several threads log to the same file
+    flockfile(file);
+    fprintf(file,
+            "{\"source\":\"%s\",\"n\":%d,\"k\":%d,\"row\":%d,\"col\":%d,\"wall_us\":%.3f,"
+            "\"nodes\":%llu,\"leaves\":%llu,\"cutoffs\":%llu,\"tt_hits\":%llu,\"tt_misses\":%llu,"
+            "\"lookup_hits\":%llu,\"lookup_misses\":%llu,\"depth\":%d,\"branching\":%.4f,\"ply_nodes\":[",
+            sourceNames[source], stats->n, stats->k, stats->move.row, stats->move.col, stats->wallNs / 1e3,
+            (unsigned long long)stats->nodes, (unsigned long long)stats->leaves,
+            (unsigned long long)stats->cutoffs, (unsigned long long)stats->ttHits,
+            (unsigned long long)stats->ttMisses, (unsigned long long)stats->lookupHits,
+            (unsigned long long)stats->lookupMisses, depth, searchStatsBranching(stats));
+    for (int ply = 1; ply <= depth; ply++)
+    {
+        fprintf(file, (ply == 1) ? "%llu" : ",%llu", (unsigned long long)stats->plyNodes[ply]);
+    }
+    fprintf(file, "]}\n");
+    fflush(file);
+    funlockfile(file);
+}
@@ -0,0 +1,230 @@
+#include <threadPool.h>
+#include <unistd.h>
+
+static __thread struct ThreadPool *workerPool = NULL; /**< Pool of the calling worker, NULL outside any pool */
+static __thread int workerIndex = ERROR; /**< Deque of the calling worker in `workerPool` */
+
+int poolCoreCount()
+{
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    return (cores < 1) ? 1 : (int)cores;
+}
+
+static bool dequePush(struct PoolDeque *dq, struct PoolTask task)
+{
+    pthread_mutex_lock(&dq->lock);
+    bool isFull = dq->bottom - dq->top == POOL_DEQUE_SIZE;
+    if (!isFull)
+    {
+        dq->tasks[dq->bottom++ % POOL_DEQUE_SIZE] = task;
+    }
+    pthread_mutex_unlock(&dq->lock);
+    return !isFull;
+}
+
+// Owner side: newest task first, keeps the working set of a split warm in its cache
+static bool dequePopBottom(struct PoolDeque *dq, struct PoolTask *task)
+{
+    pthread_mutex_lock(&dq->lock);
+    bool isEmpty = dq->bottom == dq->top;
+    if (!isEmpty)
+    {
+        *task = dq->tasks[--dq->bottom % POOL_DEQUE_SIZE];
+    }
+    pthread_mutex_unlock(&dq->lock);
+    return !isEmpty;
+}
+
+// Thief side: oldest task first, which is usually the largest piece of work
+static bool dequeStealTop(struct PoolDeque *dq, struct PoolTask *task)
+{
+    pthread_mutex_lock(&dq->lock);
+    bool isEmpty = dq->bottom == dq->top;
+    if (!isEmpty)
+    {
+        *task = dq->tasks[dq->top++ % POOL_DEQUE_SIZE];
+    }
+    pthread_mutex_unlock(&dq->lock);
+    return !isEmpty;
+}
+
+static bool findTask(struct ThreadPool *pool, int self, struct PoolTask *task)
+{
+    bool isFound = self != ERROR && dequePopBottom(&pool->deques[self], task);
+
+    int start = (self == ERROR) ? 0 : self + 1;
+    for (int i = 0; i < pool->threadCount && !isFound; i++)
+    {
+        int victim = (start + i) % pool->threadCount;
+        isFound = victim != self && dequeStealTop(&pool->deques[victim], task);
+    }
+
+    if (isFound)
+    {
+        __atomic_sub_fetch(&pool->queued, 1, __ATOMIC_RELAXED);
+    }
+    return isFound;
+}
+
+static void runTask(struct ThreadPool *pool, struct PoolTask task)
+{
+    task.fn(task.arg);
+
+    pthread_mutex_lock(&pool->lock);
+    if (--pool->pending == 0)
+    {
+        pthread_cond_broadcast(&pool->allDone);
+    }
+    pthread_mutex_unlock(&pool->lock);
+}
+
+struct WorkerArg
+{
+    struct ThreadPool *pool;
+    int index;
+};
+
+static void *workerMain(void *arg)
+{
+    struct WorkerArg self = *(struct WorkerArg *)arg;
+    struct ThreadPool *pool = self.pool;
+    free(arg);
+    workerPool = pool;
+    workerIndex = self.index;
+
+    while (true)
+    {
+        struct PoolTask task;
+        if (findTask(pool, self.index, &task))
+        {
+            runTask(pool, task);
+            continue;
+        }
+
+        // Nothing to steal: sleep until more work is queued
+        pthread_mutex_lock(&pool->lock);
+        while (!pool->shutdown && __atomic_load_n(&pool->queued, __ATOMIC_RELAXED) <= 0)
+        {
+            pthread_cond_wait(&pool->workAvailable, &pool->lock);
+        }
+        bool isShutdown = pool->shutdown;
+        pthread_mutex_unlock(&pool->lock);
+
+        if (isShutdown)
+        {
+            return NULL;
+        }
+    }
+}
+
+struct ThreadPool *poolCreate(int threadCount)
+{
+    struct ThreadPool *pool = calloc(1, sizeof(struct ThreadPool));
+    if (pool == NULL)
+    {
+        return NULL;
+    }
+
+    threadCount = (threadCount < 1) ? 1 : (threadCount > POOL_MAX_THREADS) ? POOL_MAX_THREADS : threadCount;
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->workAvailable, NULL);
+    pthread_cond_init(&pool->allDone, NULL);
+    for (int i = 0; i < POOL_MAX_THREADS; i++)
+    {
+        pthread_mutex_init(&pool->deques[i].lock, NULL);
+    }
+
+    for (int i = 0; i < threadCount; i++)
+    {
+        struct WorkerArg *arg = malloc(sizeof(struct WorkerArg));
+        if (arg == NULL)
+        {
+            break;
+        }
+        arg->pool = pool;
+        arg->index = i;
+
+        // workers only steal from deques below threadCount, so publish it before starting
+        pool->threadCount = i + 1;
+        if (pthread_create(&pool->threads[i], NULL, workerMain, arg) != 0)
+        {
+            free(arg);
+            pool->threadCount = i;
+            break;
+        }
+    }
+
+    if (pool->threadCount == 0)
+    {
+        LOG_ERROR("[ERROR] Could not start any search thread\n");
+        free(pool);
+        return NULL;
+    }
+    return pool;
+}
+
+void poolSubmit(struct ThreadPool *pool, void (*fn)(void *arg), void *arg)
+{
+    struct PoolTask task = {fn, arg};
+
+    pthread_mutex_lock(&pool->lock);
+    pool->pending++;
+    // a task of another pool submitting here is an outside thread to this one
+    int target = (workerPool == pool) ? workerIndex : (int)(pool->nextDeque++ % pool->threadCount);
+    pthread_mutex_unlock(&pool->lock);
+
+    if (!dequePush(&pool->deques[target], task))
+    {
+        runTask(pool, task);
+        return;
+    }
+
+    // counted under the pool lock so a worker about to sleep cannot miss it
+    pthread_mutex_lock(&pool->lock);
+    __atomic_add_fetch(&pool->queued, 1, __ATOMIC_RELAXED);
+    pthread_cond_signal(&pool->workAvailable);
+    pthread_mutex_unlock(&pool->lock);
+}
+
+void poolWait(struct ThreadPool *pool)
+{
+    // Help with the batch instead of sleeping on it
+    struct PoolTask task;
+    while (findTask(pool, ERROR, &task))
+    {
+        runTask(pool, task);
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    while (pool->pending > 0)
+    {
+        pthread_cond_wait(&pool->allDone, &pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+}
+
+void poolDestroy(struct ThreadPool *pool)
+{
+    if (pool == NULL)
+    {
+        return;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    pool->shutdown = true;
+    pthread_cond_broadcast(&pool->workAvailable);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (int i = 0; i < pool->threadCount; i++)
+    {
+        pthread_join(pool->threads[i], NULL);
+    }
+    for (int i = 0; i < POOL_MAX_THREADS; i++)
+    {
+        pthread_mutex_destroy(&pool->deques[i].lock);
+    }
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->workAvailable);
+    pthread_cond_destroy(&pool->allDone);
+    free(pool);
+}
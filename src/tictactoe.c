@@ -0,0 +1,281 @@
+#include <tictactoe.h>
+#include <minimax.h>
+#include <mcts.h>
+#include <ml-naive-bayes.h>
+
+/**
+ * @struct Engine
+ * @brief Settings shared by games, and the model they play `MODE_ML` with.
+ */
+struct Engine
+{
+    struct EngineConfig config;
+    pthread_mutex_t lock;           /**< Guards `model` and `hasModel` against a retrain */
+    struct NaiveBayesModel model;
+    bool hasModel;
+};
+
+/**
+ * @struct Game
+ * @brief One board, its side to move and the context its searches run in.
+ */
+struct Game
+{
+    struct Engine *engine;
+    struct GameState state;
+    int turn;                    /**< `PLAYER1` or `BOT` */
+    struct SearchContext search;
+};
+
+static pthread_mutex_t datasetLock = PTHREAD_MUTEX_INITIALIZER; /**< The dataset files are one per process */
+
+void engineDefaultConfig(struct EngineConfig *config)
+{
+    config->searchMode = (MINIMAX_ALPHABETA) ? SEARCH_ALPHABETA : SEARCH_MINIMAX;
+    config->depthLimit = (MINIMAX_GODMODE) ? NO_DEPTH_LIMIT : MINIMAX_DEPTH_LIMIT;
+    config->timeBudget = MOVE_TIME_BUDGET_MS;
+    config->threads = SEARCH_THREADS;
+    config->mctsPlayouts = MCTS_PLAYOUTS;
+    config->useModel = true;
+}
+
+struct Engine *engineCreate(const struct EngineConfig *config)
+{
+    struct Engine *engine = malloc(sizeof(struct Engine));
+    if (engine == NULL)
+    {
+        return NULL;
+    }
+
+    if (config != NULL)
+    {
+        engine->config = *config;
+    }
+    else
+    {
+        engineDefaultConfig(&engine->config);
+    }
+
+    pthread_mutex_init(&engine->lock, NULL);
+    engine->hasModel = false;
+    if (engine->config.useModel)
+    {
+        pthread_mutex_lock(&datasetLock);
+        engine->hasModel = initData(&engine->model) == SUCCESS;
+        pthread_mutex_unlock(&datasetLock);
+    }
+
+#if !(DISABLE_LOOKUP)
+    loadBoardStates(); // read the minimax lookup file once, moves are then served from memory
+#endif
+    return engine;
+}
+
+bool engineHasModel(struct Engine *engine)
+{
+    pthread_mutex_lock(&engine->lock);
+    bool hasModel = engine->hasModel;
+    pthread_mutex_unlock(&engine->lock);
+    return hasModel;
+}
+
+int engineRetrainModel(struct Engine *engine)
+{
+    // train aside, so the games keep playing the old model until the new one is whole
+    struct NaiveBayesModel model;
+    struct Dataset data[DATA_SIZE];
+    pthread_mutex_lock(&datasetLock);
+    int retVal = readDataset(RES_PATH "" DATA_PATH, true, data);
+    if (retVal == SUCCESS)
+    {
+        retVal = initData(&model);
+    }
+    pthread_mutex_unlock(&datasetLock);
+
+    pthread_mutex_lock(&engine->lock);
+    if (retVal == SUCCESS)
+    {
+        engine->model = model;
+    }
+    engine->hasModel = retVal == SUCCESS;
+    pthread_mutex_unlock(&engine->lock);
+    return retVal;
+}
+
+void engineDestroy(struct Engine *engine)
+{
+    if (engine != NULL)
+    {
+        pthread_mutex_destroy(&engine->lock);
+        free(engine);
+    }
+}
+
+struct Game *gameCreate(struct Engine *engine, int n, int k)
+{
+    if (!nkIsValidSize(n, k))
+    {
+        return NULL;
+    }
+
+    struct Game *game = malloc(sizeof(struct Game));
+    if (game == NULL)
+    {
+        return NULL;
+    }
+
+    game->engine = engine;
+    searchContextInit(&game->search);
+    gameConfigure(game, &engine->config);
+
+    gsInit(&game->state, n, k);
+    game->turn = PLAYER1;
+    return game;
+}
+
+void gameConfigure(struct Game *game, const struct EngineConfig *config)
+{
+    game->search.mode = config->searchMode;
+    game->search.depthLimit = config->depthLimit;
+    game->search.timeBudget = config->timeBudget;
+    game->search.threads = config->threads;
+    game->search.mctsPlayouts = config->mctsPlayouts;
+}
+
+void gameReset(struct Game *game)
+{
+    gsInit(&game->state, game->state.board.n, game->state.board.k);
+    game->turn = PLAYER1;
+}
+
+void gameDestroy(struct Game *game)
+{
+    if (game != NULL)
+    {
+        searchContextRelease(&game->search);
+        free(game);
+    }
+}
+
+int gamePlay(struct Game *game, int row, int col)
+{
+    struct GameState *s = &game->state;
+    int n = s->board.n;
+    if (gsWinner(s) != EMPTY || gsIsFull(s) || row < 0 || row >= n || col < 0 || col >= n ||
+        (gsEmpty(s) >> (row * n + col) & 1) == 0)
+    {
+        return BAD_PARAM;
+    }
+
+    gsMake(s, row * n + col, game->turn);
+    game->turn = (game->turn == PLAYER1) ? BOT : PLAYER1;
+
+    if (gsWinner(s) != EMPTY)
+    {
+        return WIN;
+    }
+    return gsIsFull(s) ? TIE : PLAY;
+}
+
+struct Position gameBotMove(struct Game *game, int mode)
+{
+    if (gsWinner(&game->state) != EMPTY || gsIsFull(&game->state))
+    {
+        return (struct Position){ERROR, ERROR};
+    }
+
+    struct NKBoard b = game->state.board;
+    if (game->turn == PLAYER1)
+    {
+        // the engines always play the BOT's stones
+        b.bot = game->state.board.player;
+        b.player = game->state.board.bot;
+    }
+    return gameSearch(game, b, mode);
+}
+
+struct Position gameSearch(struct Game *game, struct NKBoard b, int mode)
+{
+    struct Position move = {ERROR, ERROR};
+    if (game->search.cancelled || nkEmpty(&b) == 0)
+    {
+        return move;
+    }
+
+    struct SearchContext *outer = searchEnter(&game->search);
+    if (mode == MODE_MM)
+    {
+        move = findBestMoveNK(b);
+    }
+    else if (mode == MODE_MC)
+    {
+        move = findBestMoveMCTS(b);
+    }
+    else if (mode == MODE_ML && b.n == 3 && b.k == 3) // the dataset only covers 3x3
+    {
+        int grid[3][3];
+        for (int idx = 0; idx < BB_CELLS; idx++)
+        {
+            grid[BB_ROW(idx)][BB_COL(idx)] = (b.bot >> idx & 1) ? BOT : (b.player >> idx & 1) ? PLAYER1 : EMPTY;
+        }
+        struct Engine *engine = game->engine;
+        pthread_mutex_lock(&engine->lock);
+        if (engine->hasModel)
+        {
+            move = getBestPosition(&engine->model, grid, 'x');
+        }
+        pthread_mutex_unlock(&engine->lock);
+    }
+    searchLeave(outer);
+
+    return game->search.cancelled ? (struct Position){ERROR, ERROR} : move;
+}
+
+void gameCancel(struct Game *game, bool isCancelled)
+{
+    game->search.cancelled = isCancelled;
+}
+
+void gameStop(struct Game *game, bool isStopped)
+{
+    game->search.stopped = isStopped;
+}
+
+bool gameIsCancelled(const struct Game *game)
+{
+    return game->search.cancelled;
+}
+
+void gameSearchStats(const struct Game *game, struct SearchStats *stats)
+{
+    *stats = game->search.stats;
+}
+
+struct NKBoard gameBoard(const struct Game *game)
+{
+    return game->state.board;
+}
+
+int gameTurn(const struct Game *game)
+{
+    return game->turn;
+}
+
+int gameWinner(const struct Game *game)
+{
+    return gsWinner(&game->state);
+}
+
+uint64_t gameWinLine(const struct Game *game)
+{
+    const struct NKBoard *b = &game->state.board;
+    switch (gsWinner(&game->state))
+    {
+    case BOT:
+        return nkWinLine(b->bot, b->n, b->k);
+    case PLAYER1:
+        return nkWinLine(b->player, b->n, b->k);
+    default:
+        return 0;
+    }
+}
@@ -0,0 +1,175 @@
+#include <transposition.h>
+
+/**
+ * A slot keeps the entry packed into one word plus the key XORed with that word. Threads
+ * write both words without a lock; a slot torn by two concurrent writers no longer
+ * decodes to its key and is treated as a miss.
+ */
+struct TTSlot
+{
+    uint64_t check; /**< key ^ data */
+    uint64_t data;  /**< score | bound << 16 | depth << 24 */
+};
+
+static struct TTSlot ttTable[TT_SIZE];
+
+static uint64_t zobristCell[2][BB_CELLS]; /**< [0] bot, [1] player */
+static uint64_t zobristBotToMove;
+static uint64_t zobristCellNK[2][MAX_CELLS];            /**< [0] bot, [1] player, N x N boards */
+static uint64_t zobristSizeNK[MAX_N + 1][MAX_N + 1];     /**< Keeps boards of different N and K apart */
+
+static uint16_t bbSymTable[BB_SYMMETRIES][BB_FULL + 1];
+
+// Cell each cell (row, col) is sent to by the 8 symmetries of the square
+static int symCell(int s, int row, int col)
+{
+    switch (s)
+    {
+    case 0: return row * 3 + col;               // identity
+    case 1: return col * 3 + (2 - row);         // rotate 90
+    case 2: return (2 - row) * 3 + (2 - col);   // rotate 180
+    case 3: return (2 - col) * 3 + row;         // rotate 270
+    case 4: return row * 3 + (2 - col);         // mirror left-right
+    case 5: return (2 - row) * 3 + col;         // mirror top-bottom
+    case 6: return col * 3 + row;               // main diagonal
+    default: return (2 - col) * 3 + (2 - row);  // anti diagonal
+    }
+}
+
+static uint64_t splitmix64(uint64_t *state)
+{
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+__attribute__((constructor)) static void ttInitTables()
+{
+    for (int s = 0; s < BB_SYMMETRIES; s++)
+    {
+        for (int mask = 0; mask <= BB_FULL; mask++)
+        {
+            uint16_t out = 0;
+            for (int idx = 0; idx < BB_CELLS; idx++)
+            {
+                if (mask & (1 << idx))
+                {
+                    out |= (uint16_t)(1u << symCell(s, BB_ROW(idx), BB_COL(idx)));
+                }
+            }
+            bbSymTable[s][mask] = out;
+        }
+    }
+
+    // fixed seed so keys are reproducible between runs
+    uint64_t seed = 0x7469637461637465ULL;
+    for (int side = 0; side < 2; side++)
+    {
+        for (int idx = 0; idx < BB_CELLS; idx++)
+        {
+            zobristCell[side][idx] = splitmix64(&seed);
+        }
+    }
+    zobristBotToMove = splitmix64(&seed);
+
+    for (int side = 0; side < 2; side++)
+    {
+        for (int idx = 0; idx < MAX_CELLS; idx++)
+        {
+            zobristCellNK[side][idx] = splitmix64(&seed);
+        }
+    }
+    for (int n = 0; n <= MAX_N; n++)
+    {
+        for (int k = 0; k <= MAX_N; k++)
+        {
+            zobristSizeNK[n][k] = splitmix64(&seed);
+        }
+    }
+}
+
+struct BitBoard bbCanonical(struct BitBoard b)
+{
+    struct BitBoard best = b;
+    uint32_t bestPacked = (uint32_t)b.bot | ((uint32_t)b.player << BB_CELLS);
+
+    for (int s = 1; s < BB_SYMMETRIES; s++)
+    {
+        uint16_t bot = bbSymTable[s][b.bot];
+        uint16_t player = bbSymTable[s][b.player];
+        uint32_t packed = (uint32_t)bot | ((uint32_t)player << BB_CELLS);
+        if (packed < bestPacked)
+        {
+            bestPacked = packed;
+            best.bot = bot;
+            best.player = player;
+        }
+    }
+    return best;
+}
+
+uint64_t ttKey(struct BitBoard b, bool isMax)
+{
+    struct BitBoard c = bbCanonical(b);
+    uint64_t key = isMax ? zobristBotToMove : 0;
+
+    for (uint16_t m = c.bot; m;)
+    {
+        key ^= zobristCell[0][bbPopLowest(&m)];
+    }
+    for (uint16_t m = c.player; m;)
+    {
+        key ^= zobristCell[1][bbPopLowest(&m)];
+    }
+    return key ? key : 1; // 0 marks an empty slot
+}
+
+uint64_t ttKeyNK(const struct NKBoard *b, bool isMax)
+{
+    uint64_t key = zobristSizeNK[b->n][b->k] ^ (isMax ? zobristBotToMove : 0);
+
+    for (uint64_t m = b->bot; m;)
+    {
+        key ^= zobristCellNK[0][nkPopLowest(&m)];
+    }
+    for (uint64_t m = b->player; m;)
+    {
+        key ^= zobristCellNK[1][nkPopLowest(&m)];
+    }
+    return key;
+}
+
+uint64_t ttMoveKeyNK(int idx, bool isBot)
+{
+    return zobristCellNK[isBot ? 0 : 1][idx] ^ zobristBotToMove;
+}
+
+bool ttProbe(uint64_t key, int depth, struct TTEntry *entry)
+{
+    struct TTSlot *slot = &ttTable[key & (TT_SIZE - 1)];
+    uint64_t check = __atomic_load_n(&slot->check, __ATOMIC_RELAXED);
+    uint64_t data = __atomic_load_n(&slot->data, __ATOMIC_RELAXED);
+    if ((check ^ data) != key || (uint8_t)(data >> 24) != depth)
+    {
+        return false;
+    }
+    entry->key = key;
+    entry->score = (int16_t)data;
+    entry->bound = (uint8_t)(data >> 16);
+    entry->depth = (uint8_t)(data >> 24);
+    return true;
+}
+
+void ttStore(uint64_t key, int depth, int score, int bound)
+{
+    struct TTSlot *slot = &ttTable[key & (TT_SIZE - 1)];
+    uint64_t data = (uint16_t)score | (uint64_t)(uint8_t)bound << 16 | (uint64_t)(uint8_t)depth << 24;
+    __atomic_store_n(&slot->check, key ^ data, __ATOMIC_RELAXED);
+    __atomic_store_n(&slot->data, data, __ATOMIC_RELAXED);
+}
+
+void ttClear()
+{
+    memset(ttTable, 0, sizeof(ttTable));
+}
@@ -0,0 +1,53 @@
+/**
+ * @file benchMcts.c
+ * @author jacktan-jk
+ * @brief Measures Monte Carlo Tree Search playouts per second.
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2024
+ *
+ * Runs a fixed number of playouts from the same opening of every specialised board size
+ * with 1, 2, 4 and 8 threads and prints the playout rate.
+ * @code
+ * ./benchMcts [playouts]
+ * @endcode
+ */
+
+#include <mcts.h>
+#include <minimax.h>
+
+static double nowSeconds()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + 1.0e-9 * ts.tv_nsec;
+}
+
+int main(int argc, char *argv[])
+{
+    const int boards[][2] = {{3, 3}, {4, 4}, {5, 4}, {7, 5}, {8, 5}}; // N, K
+    const int threadCounts[] = {1, 2, 4, 8};
+    mctsPlayouts = (argc > 1 && atoi(argv[1]) > 0) ? atoi(argv[1]) : 200000;
+
+    printf("%d cores online, %d playouts per search\n", poolCoreCount(), mctsPlayouts);
+    for (int i = 0; i < (int)(sizeof(boards) / sizeof(boards[0])); i++)
+    {
+        int n = boards[i][0], k = boards[i][1];
+        struct NKBoard b = {0, 0, n, k};
+        b.bot |= NK_BIT(n, n / 2, n / 2);
+        b.player |= NK_BIT(n, n / 2, n / 2 - 1);
+
+        for (int t = 0; t < (int)(sizeof(threadCounts) / sizeof(threadCounts[0])); t++)
+        {
+            searchThreads = threadCounts[t];
+            long playouts;
+            double start = nowSeconds();
+            struct Position move = mctsRun(b, &playouts);
+            double elapsed = nowSeconds() - start;
+            printf("%dx%d K=%d, %d threads: %9.0f playouts/sec  move R:%d C:%d\n",
+                   n, n, k, threadCounts[t], playouts / elapsed, move.row, move.col);
+        }
+    }
+    return SUCCESS;
+}
@@ -0,0 +1,62 @@
+/**
+ * @file benchParallel.c
+ * @author jacktan-jk
+ * @brief Times the parallel N x N search against the serial one.
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2024
+ *
+ * Searches the same opening of each specialised large board to a fixed depth with 1, 2,
+ * 4 and 8 threads and prints the time, node count and speedup over the serial search.
+ * The score must be the same for every thread count.
+ * @code
+ * ./benchParallel [runs]
+ * @endcode
+ */
+
+#include <minimax.h>
+
+static double nowSeconds()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + 1.0e-9 * ts.tv_nsec;
+}
+
+int main(int argc, char *argv[])
+{
+    const int boards[][3] = {{5, 4, 10}, {7, 5, 8}, {8, 5, 8}}; // N, K, depth
+    const int threadCounts[] = {1, 2, 4, 8};
+    int runs = (argc > 1 && atoi(argv[1]) > 0) ? atoi(argv[1]) : 3;
+
+    // results go to stderr so they stand apart from the log records of the search
+    fprintf(stderr, "%d cores online, best of %d runs\n", poolCoreCount(), runs);
+    for (int i = 0; i < (int)(sizeof(boards) / sizeof(boards[0])); i++)
+    {
+        int n = boards[i][0], k = boards[i][1], depth = boards[i][2];
+        struct NKBoard b = {0, 0, n, k};
+        b.bot |= NK_BIT(n, n / 2, n / 2);
+        b.player |= NK_BIT(n, n / 2, n / 2 - 1);
+
+        double serial = 0;
+        for (int t = 0; t < (int)(sizeof(threadCounts) / sizeof(threadCounts[0])); t++)
+        {
+            searchThreads = threadCounts[t];
+            double best = 1e9;
+            struct Position move = {ERROR, ERROR};
+            for (int r = 0; r < runs; r++)
+            {
+                ttClear();
+                double start = nowSeconds();
+                move = searchBestMoveNK(b, depth);
+                double elapsed = nowSeconds() - start;
+                best = (elapsed < best) ? elapsed : best;
+            }
+            serial = (t == 0) ? best : serial;
+            fprintf(stderr, "%dx%d K=%d depth %2d, %d threads: %8.3f ms  speedup %.2fx  move R:%d C:%d\n",
+                    n, n, k, depth, threadCounts[t], best * 1000, serial / best, move.row, move.col);
+        }
+    }
+    return SUCCESS;
+}
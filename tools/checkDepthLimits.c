@@ -0,0 +1,106 @@
+/**
+ * @file checkDepthLimits.c
+ * @author jacktan-jk
+ * @brief Checks that searches at different depth limits do not share transposition entries.
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2024
+ *
+ * Every `SearchContext` has its own `depthLimit` but all of them probe one transposition
+ * table. For each search mode and each ordered pair of limits (A, B), the table is
+ * cleared, every 3x3 position the bot can be asked to play is solved at limit A and then
+ * again at limit B with `searchBestMove()`. The moves found at B must be the ones found
+ * at B with a cleared table. Prints the mismatches of each pair and exits with `ERROR`
+ * if there is any. Run by `compile.sh` after the library is built:
+ * @code
+ * ./checkDepthLimits
+ * @endcode
+ */
+
+#include <minimax.h>
+
+static const int limits[] = {0, 1, MINIMAX_DEPTH_LIMIT, 3, 5, NO_DEPTH_LIMIT};
+#define LIMITS ((int)(sizeof(limits) / sizeof(limits[0])))
+
+// Same filter as genMoveTable: legal piece counts, nobody has won, an empty cell left
+static bool decodeBotToMove(int code, int board[3][3])
+{
+    for (int idx = 0; idx < BB_CELLS; idx++)
+    {
+        board[BB_ROW(idx)][BB_COL(idx)] = code % 3;
+        code /= 3;
+    }
+
+    struct BitBoard bb = bbFromArray(board);
+    int players = bbCount(bb.player);
+    int bots = bbCount(bb.bot);
+    if (players != bots && players != bots + 1)
+    {
+        return false;
+    }
+    return !bbIsWin(bb.bot) && !bbIsWin(bb.player) && bbEmpty(bb) != 0;
+}
+
+// Solves every position at one limit, on whatever the table holds
+static void solveAll(int limit, uint8_t moves[MOVETABLE_SIZE])
+{
+    int board[3][3];
+    searchDepthLimit = limit;
+    for (int code = 0; code < MOVETABLE_SIZE; code++)
+    {
+        moves[code] = MOVETABLE_NONE;
+        if (decodeBotToMove(code, board))
+        {
+            struct Position move = searchBestMove(board);
+            moves[code] = (uint8_t)(move.row * 3 + move.col + 1);
+        }
+    }
+}
+
+int main()
+{
+    static uint8_t expected[LIMITS][MOVETABLE_SIZE];
+    static uint8_t moves[MOVETABLE_SIZE];
+    logSetLevel(LOG_LEVEL_WARN); // every search logs its node count
+    int failures = 0;
+
+    for (int mode = SEARCH_MINIMAX; mode <= SEARCH_ALPHABETA; mode++)
+    {
+        searchMode = mode;
+        for (int b = 0; b < LIMITS; b++)
+        {
+            ttClear();
+            solveAll(limits[b], expected[b]);
+        }
+
+        for (int a = 0; a < LIMITS; a++)
+        {
+            for (int b = 0; b < LIMITS; b++)
+            {
+                if (a == b)
+                {
+                    continue;
+                }
+                ttClear();
+                solveAll(limits[a], moves);
+                solveAll(limits[b], moves);
+
+                int wrong = 0;
+                for (int code = 0; code < MOVETABLE_SIZE; code++)
+                {
+                    wrong += moves[code] != expected[b][code];
+                }
+                if (wrong > 0)
+                {
+                    printf("[CHECK] %s: limit %d after limit %d: %d positions get another move\n",
+                           mode == SEARCH_ALPHABETA ? "Alpha-beta" : "Minimax", limits[b], limits[a], wrong);
+                }
+                failures += wrong;
+            }
+        }
+    }
+
+    printf("[CHECK] Depth limits %s\n", failures == 0 ? "share no transposition entries" : "FAILED");
+    return failures == 0 ? SUCCESS : ERROR;
+}
@@ -0,0 +1,43 @@
+/**
+ * @file convertBestMove.c
+ * @author jacktan-jk
+ * @brief Converts the legacy CSV best move file into the binary memory-mapped format.
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2024
+ *
+ * Usage:
+ * @code
+ * ./convertBestMove [resources/bestmove.txt] [resources/bestmove.bin]
+ * @endcode
+ * Moves are merged into the binary file if it already exists, in the namespace of the
+ * build's default settings; a board keeps the first move stored for it.
+ */
+
+#include <bestMoveStore.h>
+
+int main(int argc, char *argv[])
+{
+    const char *txtPath = (argc > 1) ? argv[1] : FILE_BESTMOV_TXT;
+    const char *binPath = (argc > 2) ? argv[2] : FILE_BESTMOV;
+
+    if (openBestMoveFile(binPath) == ERROR)
+    {
+        fprintf(stderr, "[ERROR] Cannot map %s\n", binPath);
+        return ERROR;
+    }
+
+    int lines = importBestMoveText(txtPath, bestMoveDefaultKey());
+    if (lines < 0)
+    {
+        fprintf(stderr, "[ERROR] Cannot read %s\n", txtPath);
+        closeBoardStates();
+        return BAD_PARAM;
+    }
+
+    int stored = loadBoardStates();
+    closeBoardStates();
+    printf("[CONVERT] %d records from %s -> %d boards in %s\n", lines, txtPath, stored, binPath);
+    return SUCCESS;
+}
@@ -0,0 +1,105 @@
+/**
+ * @file genMoveTable.c
+ * @author jacktan-jk
+ * @brief Build-time generator for the perfect-play move tables in `moveTable.h`.
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2024
+ *
+ * Solves every 3x3 position the bot can be asked to play with `searchBestMove()`, once
+ * with the full-depth search and once with the depth-limited search, and writes both
+ * tables as C source. Run by `compile.sh` before the application is compiled:
+ * @code
+ * ./genMoveTable src/moveTable.c
+ * @endcode
+ */
+
+#include <minimax.h>
+
+// The generator links minimax.c, whose table lookup reads these. Empty tables make
+// findBestMove() fall through to the search, but only searchBestMove() is used here.
+const uint8_t moveTableGodmode[MOVETABLE_SIZE] = {0};
+const uint8_t moveTableDepthLimited[MOVETABLE_SIZE] = {0};
+
+/**
+ * @brief Decodes a base-3 board code and checks the bot can be asked to move on it.
+ *
+ * @param code The base-3 code, cell `idx` weighted by `3^idx`.
+ * @param board Output 3x3 board.
+ * @return `true` if the piece counts are legal for either side starting, nobody has won
+ *         and at least one cell is empty.
+ */
+static bool decodeBotToMove(int code, int board[3][3])
+{
+    for (int idx = 0; idx < BB_CELLS; idx++)
+    {
+        board[BB_ROW(idx)][BB_COL(idx)] = code % 3;
+        code /= 3;
+    }
+
+    struct BitBoard bb = bbFromArray(board);
+    int players = bbCount(bb.player);
+    int bots = bbCount(bb.bot);
+    if (players != bots && players != bots + 1)
+    {
+        return false;
+    }
+    return !bbIsWin(bb.bot) && !bbIsWin(bb.player) && bbEmpty(bb) != 0;
+}
+
+/**
+ * @brief Solves every position with the current `searchDepthLimit` and emits one table.
+ *
+ * @return The number of positions solved.
+ */
+static int writeTable(FILE *out, const char *name)
+{
+    int solved = 0;
+    int board[3][3];
+
+    ttClear();
+    fprintf(out, "const uint8_t %s[MOVETABLE_SIZE] = {", name);
+    for (int code = 0; code < MOVETABLE_SIZE; code++)
+    {
+        int slot = MOVETABLE_NONE;
+        if (decodeBotToMove(code, board))
+        {
+            struct Position move = searchBestMove(board);
+            slot = move.row * 3 + move.col + 1;
+            solved++;
+        }
+        fprintf(out, "%s%d,", (code % 32 == 0) ? "\n    " : "", slot);
+    }
+    fprintf(out, "\n};\n\n");
+    return solved;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc != 2)
+    {
+        fprintf(stderr, "Usage: %s OUTPUT.c\n", argv[0]);
+        return BAD_PARAM;
+    }
+
+    FILE *out = fopen(argv[1], "w");
+    if (out == NULL)
+    {
+        fprintf(stderr, "[ERROR] Cannot open %s for writing.\n", argv[1]);
+        return ERROR;
+    }
+
+    fprintf(out, "// Generated by tools/genMoveTable.c, do not edit.\n");
+    fprintf(out, "#include <moveTable.h>\n\n");
+
+    searchDepthLimit = NO_DEPTH_LIMIT;
+    int solved = writeTable(out, "moveTableGodmode");
+
+    searchDepthLimit = MINIMAX_DEPTH_LIMIT;
+    writeTable(out, "moveTableDepthLimited");
+
+    fclose(out);
+    fprintf(stderr, "[GENERATE] Solved %d positions into %s\n", solved, argv[1]);
+    return SUCCESS;
+}
@@ -0,0 +1,233 @@
+/**
+ * @file loadGen.c
+ * @author jacktan-jk
+ * @brief Load generator for `tictactoeServer`: bot moves per second and their latency.
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2024
+ *
+ * Opens many connections and keeps one request in flight on each, from one epoll loop.
+ * Every connection plays games against the server's bot: `NEW`, then a random human
+ * `MOVE` and a `BOT` request in turn until the game ends, then a new game. Once the time
+ * is up it prints the games and requests served, the bot moves per second and the
+ * percentiles of the `BOT` round trip.
+ * @code
+ * ./loadGen [connections] [seconds] [socket path | port] [N] [K] [MM|ML|MC]
+ * ./loadGen 1000 10 /tmp/tictactoe.sock 3 3 MM
+ * @endcode
+ */
+
+#include <serverProtocol.h>
+#include <nkBoard.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+
+#define LOADGEN_MAX_EVENTS 256 /**< Events taken from one `epoll_wait()` */
+
+/**
+ * @struct Conn
+ * @brief A connection, the board it plays on and the request in flight.
+ */
+struct Conn
+{
+    int fd;
+    struct NKBoard board;  /**< Human (PLAYER1) and bot stones as the server replied */
+    bool isBotRequest;     /**< Whether the request in flight is `BOT` */
+    double sentAt;         /**< When the request in flight was written */
+    int inLen;
+    char in[SERVER_LINE_MAX];
+};
+
+static int n = 3, k = 3;
+static const char *mode = "MM";
+static uint64_t rng = 0x9E3779B97F4A7C15ULL;
+static double *latencies;     /**< Round trips of the `BOT` requests, in seconds */
+static long latencyCount, latencyCap;
+static long requests, games, errors;
+
+static double nowSeconds()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + 1.0e-9 * ts.tv_nsec;
+}
+
+static int compareDouble(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static bool sendRequest(struct Conn *c, const char *line, bool isBotRequest)
+{
+    c->isBotRequest = isBotRequest;
+    c->sentAt = nowSeconds();
+    size_t len = strlen(line);
+    return write(c->fd, line, len) == (ssize_t)len; // one short line fits the socket buffer
+}
+
+static bool newGame(struct Conn *c)
+{
+    char line[SERVER_LINE_MAX];
+    snprintf(line, sizeof(line), "NEW %d %d %s\n", n, k, mode);
+    c->board = (struct NKBoard){0, 0, n, k};
+    return sendRequest(c, line, false);
+}
+
+static bool humanMove(struct Conn *c)
+{
+    uint64_t empty = nkEmpty(&c->board);
+    rng ^= rng << 13;
+    rng ^= rng >> 7;
+    rng ^= rng << 17;
+    for (int skip = (int)((rng >> 32) % (uint64_t)__builtin_popcountll(empty)); skip > 0; skip--)
+    {
+        nkPopLowest(&empty);
+    }
+    int cell = nkPopLowest(&empty);
+    c->board.player |= 1ULL << cell;
+
+    char line[SERVER_LINE_MAX];
+    snprintf(line, sizeof(line), "MOVE %d %d\n", cell / n, cell % n);
+    return sendRequest(c, line, false);
+}
+
+// Reacts to one reply with the next request
+static bool onReply(struct Conn *c, const char *line)
+{
+    requests++;
+    int row, col;
+    char state[8] = "";
+
+    if (c->isBotRequest)
+    {
+        if (latencyCount == latencyCap)
+        {
+            latencyCap = latencyCap ? 2 * latencyCap : 65536;
+            latencies = realloc(latencies, latencyCap * sizeof(double));
+        }
+        latencies[latencyCount++] = nowSeconds() - c->sentAt;
+
+        if (sscanf(line, "MOVE %d %d %7s", &row, &col, state) != 3)
+        {
+            errors++;
+            games++;
+            return newGame(c);
+        }
+        c->board.bot |= 1ULL << (row * n + col);
+    }
+    else if (strcmp(line, "OK") == 0)
+    {
+        return humanMove(c); // game created
+    }
+    else if (sscanf(line, "OK %7s", state) != 1)
+    {
+        errors++;
+        games++;
+        return newGame(c);
+    }
+
+    if (strcmp(state, "PLAY") != 0)
+    {
+        games++;
+        return newGame(c);
+    }
+    return c->isBotRequest ? humanMove(c) : sendRequest(c, "BOT\n", true);
+}
+
+// Returns false if the connection failed
+static bool onReadable(struct Conn *c)
+{
+    ssize_t len = read(c->fd, c->in + c->inLen, sizeof(c->in) - c->inLen);
+    if (len <= 0)
+    {
+        return len < 0 && (errno == EAGAIN || errno == EINTR);
+    }
+    c->inLen += (int)len;
+
+    char *end;
+    while ((end = memchr(c->in, '\n', c->inLen)) != NULL)
+    {
+        *end = '\0';
+        if (!onReply(c, c->in))
+        {
+            return false;
+        }
+        int used = (int)(end - c->in) + 1;
+        memmove(c->in, end + 1, c->inLen - used);
+        c->inLen -= used;
+    }
+    return c->inLen < (int)sizeof(c->in);
+}
+
+int main(int argc, char *argv[])
+{
+    int connCount = (argc > 1) ? atoi(argv[1]) : 100;
+    double seconds = (argc > 2) ? atof(argv[2]) : 10;
+    const char *where = (argc > 3) ? argv[3] : SERVER_SOCKET_PATH;
+    n = (argc > 4) ? atoi(argv[4]) : n;
+    k = (argc > 5) ? atoi(argv[5]) : k;
+    mode = (argc > 6) ? argv[6] : mode;
+
+    struct sockaddr_storage addr;
+    socklen_t addrLen;
+    if (connCount <= 0 || seconds <= 0 || !nkIsValidSize(n, k) || serverAddress(where, &addr, &addrLen) != SUCCESS)
+    {
+        fprintf(stderr, "[ERROR] Usage: %s [connections] [seconds] [socket path | port] [N] [K] [MM|ML|MC]\n", argv[0]);
+        return BAD_PARAM;
+    }
+
+    int epollFd = epoll_create1(0);
+    struct Conn *conns = calloc(connCount, sizeof(struct Conn));
+    if (epollFd < 0 || conns == NULL)
+    {
+        return ERROR;
+    }
+
+    double start = nowSeconds();
+    for (int i = 0; i < connCount; i++)
+    {
+        struct Conn *c = &conns[i];
+        c->fd = socket(addr.ss_family, SOCK_STREAM, 0);
+        if (c->fd < 0 || connect(c->fd, (struct sockaddr *)&addr, addrLen) != 0)
+        {
+            fprintf(stderr, "[ERROR] Could not connect to %s (%d connections open)\n", where, i);
+            return ERROR;
+        }
+        struct epoll_event ev = {.events = EPOLLIN, .data.ptr = c};
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, c->fd, &ev);
+        newGame(c);
+    }
+
+    int openCount = connCount;
+    struct epoll_event events[LOADGEN_MAX_EVENTS];
+    while (openCount > 0 && nowSeconds() - start < seconds)
+    {
+        int count = epoll_wait(epollFd, events, LOADGEN_MAX_EVENTS, 100);
+        for (int i = 0; i < count; i++)
+        {
+            struct Conn *c = events[i].data.ptr;
+            if (!onReadable(c))
+            {
+                epoll_ctl(epollFd, EPOLL_CTL_DEL, c->fd, NULL);
+                close(c->fd);
+                openCount--;
+                errors++;
+            }
+        }
+    }
+    double elapsed = nowSeconds() - start;
+
+    qsort(latencies, latencyCount, sizeof(double), compareDouble);
+    double p50 = latencyCount ? latencies[latencyCount / 2] : 0;
+    double p99 = latencyCount ? latencies[latencyCount * 99 / 100] : 0;
+    double worst = latencyCount ? latencies[latencyCount - 1] : 0;
+
+    printf("%dx%d K=%d %s, %d connections, %.1f s\n", n, n, k, mode, connCount, elapsed);
+    printf("%ld games, %ld requests (%.0f/sec), %ld errors\n", games, requests, requests / elapsed, errors);
+    printf("%ld bot moves: %.0f moves/sec, latency p50 %.3f ms, p99 %.3f ms, max %.3f ms\n",
+           latencyCount, latencyCount / elapsed, 1e3 * p50, 1e3 * p99, 1e3 * worst);
+    return errors == 0 ? SUCCESS : ERROR;
+}
@@ -0,0 +1,180 @@
+/**
+ * @file perft.c
+ * @author jacktan-jk
+ * @brief Counts the game tree below a position and measures move generation speed.
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2024
+ *
+ * For every depth up to the one asked for, prints the number of positions reached after
+ * exactly that many plies by each board representation: the 3x3 array scan, the
+ * incremental `GameState`, the 3x3 bitboard and the N x N bitboard. A won or full board
+ * is not expanded. The counts of all engines must agree, and the empty 3x3 board must give the known totals
+ * (9, 72, 504, 3024, 15120, 54720, 148176, 200448, 127872), so a mismatch exits with
+ * `ERROR`. The deepest count is then repeated for `PERFT_MIN_SECONDS` to report nodes/sec.
+ *
+ * The board is a string of N x N cells, row by row: `X` for the BOT, `O` for PLAYER1 and
+ * `.` for an empty cell. PLAYER1 moves first, so the BOT is to move when it has fewer
+ * stones. The array engine uses the ASM helpers; compile.sh also builds `perftC` with
+ * `-DDISABLE_ASM=1` to time the pure C ones.
+ * @code
+ * ./perft [depth] [board] [K]
+ * ./perft 9 .........
+ * ./perft 6 ................ 4
+ * @endcode
+ */
+
+#include <minimax.h>
+
+#define PERFT_MIN_SECONDS 0.5 /**< Each engine repeats the deepest count at least this long */
+
+static const long emptyBoardPerft[BB_CELLS + 1] = {1, 9, 72, 504, 3024, 15120, 54720, 148176, 200448, 127872};
+
+enum PerftEngine
+{
+    PERFT_ARRAY,
+    PERFT_GAMESTATE,
+    PERFT_BITBOARD,
+    PERFT_NK,
+    PERFT_ENGINES
+};
+
+static const char *engineNames[PERFT_ENGINES] = {
+    (DISABLE_ASM) ? "array (C)" : "array (ASM)",
+    "game state",
+    "bitboard",
+    "N x N bitboard",
+};
+
+static double nowSeconds()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + 1.0e-9 * ts.tv_nsec;
+}
+
+// the array scan and the 3x3 bitboard only exist for 3x3
+static bool hasEngine(int engine, bool is3x3)
+{
+    return is3x3 || (engine != PERFT_ARRAY && engine != PERFT_BITBOARD);
+}
+
+static long runPerft(int engine, struct NKBoard b, int depth, bool isMax)
+{
+    switch (engine)
+    {
+    case PERFT_ARRAY:
+    {
+        int board[3][3];
+        for (int idx = 0; idx < BB_CELLS; idx++)
+        {
+            board[BB_ROW(idx)][BB_COL(idx)] = (b.bot >> idx & 1) ? BOT : (b.player >> idx & 1) ? PLAYER1 : EMPTY;
+        }
+        return perftArray(board, depth, isMax);
+    }
+    case PERFT_GAMESTATE:
+    {
+        struct GameState state;
+        gsFromBoard(&state, b);
+        return perftGameState(&state, depth, isMax);
+    }
+    case PERFT_BITBOARD:
+        return perftBitBoard((struct BitBoard){(uint16_t)b.bot, (uint16_t)b.player}, depth, isMax);
+    default:
+        return perftNK(b, depth, isMax);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    int depth = (argc > 1) ? atoi(argv[1]) : BB_CELLS;
+    const char *cells = (argc > 2) ? argv[2] : ".........";
+    int len = (int)strlen(cells);
+    int n = MIN_N;
+    while (n * n < len)
+    {
+        n++;
+    }
+    int k = (argc > 3) ? atoi(argv[3]) : (n < 5 ? n : 5);
+
+    if (n * n != len || !nkIsValidSize(n, k) || depth < 0)
+    {
+        fprintf(stderr, "[ERROR] Usage: %s [depth] [board of N x N cells from X, O, .] [K]\n", argv[0]);
+        return BAD_PARAM;
+    }
+
+    struct NKBoard b = {0, 0, n, k};
+    for (int idx = 0; idx < len; idx++)
+    {
+        if (cells[idx] == 'X' || cells[idx] == 'x')
+        {
+            b.bot |= 1ULL << idx;
+        }
+        else if (cells[idx] == 'O' || cells[idx] == 'o')
+        {
+            b.player |= 1ULL << idx;
+        }
+    }
+    bool isMax = __builtin_popcountll(b.bot) < __builtin_popcountll(b.player);
+    int maxDepth = __builtin_popcountll(nkEmpty(&b));
+    depth = (depth > maxDepth) ? maxDepth : depth;
+
+    bool is3x3 = n == 3 && k == 3;
+    int first = is3x3 ? PERFT_ARRAY : PERFT_GAMESTATE;
+    bool isEmptyBoard = is3x3 && b.bot == 0 && b.player == 0;
+
+    printf("%dx%d K=%d, %s to move\n", n, n, k, isMax ? "X (BOT)" : "O (PLAYER1)");
+    printf("depth %16s", "positions");
+    for (int e = first; e < PERFT_ENGINES; e++)
+    {
+        if (!hasEngine(e, is3x3))
+        {
+            continue;
+        }
+        printf("  %-16s", engineNames[e]);
+    }
+    printf("\n");
+
+    // every depth, so the deepest run's nodes are the sum of the rows
+    long totalNodes = 0;
+    int status = SUCCESS;
+    for (int d = 1; d <= depth; d++)
+    {
+        long reference = runPerft(first, b, d, isMax);
+        totalNodes += reference;
+        printf("%5d %16ld", d, reference);
+
+        for (int e = first; e < PERFT_ENGINES; e++)
+        {
+            if (!hasEngine(e, is3x3))
+            {
+                continue;
+            }
+            long count = (e == first) ? reference : runPerft(e, b, d, isMax);
+            bool isOk = count == reference && (!isEmptyBoard || count == emptyBoardPerft[d]);
+            printf("  %-16s", isOk ? "ok" : "MISMATCH");
+            status = isOk ? status : ERROR;
+        }
+        printf("\n");
+    }
+
+    for (int e = first; e < PERFT_ENGINES && depth > 0; e++)
+    {
+        if (!hasEngine(e, is3x3))
+        {
+            continue;
+        }
+        int runs = 0;
+        double start = nowSeconds(), elapsed;
+        do
+        {
+            runPerft(e, b, depth, isMax);
+            runs++;
+            elapsed = nowSeconds() - start;
+        } while (elapsed < PERFT_MIN_SECONDS);
+
+        printf("%-16s %12.0f nodes/sec (%d runs of depth %d)\n", engineNames[e], totalNodes * runs / elapsed, runs, depth);
+    }
+    return status;
+}
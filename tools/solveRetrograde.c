@@ -0,0 +1,277 @@
+/**
+ * @file solveRetrograde.c
+ * @author jacktan-jk
+ * @brief Solves every position of a small board backwards from the end of the game.
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2024
+ *
+ * Positions are grouped by the number of stones on the board. The full boards are
+ * labelled first, then each level is labelled from the level below it, which is already
+ * solved, so no position is ever visited twice. The positions of one level do not depend
+ * on each other and are split over the threads of the work-stealing pool.
+ *
+ * Positions are seen from the side to move (see gameDb.h). A level with L stones has
+ * floor(L/2) stones of the side to move and the rest of its opponent, whichever side
+ * started. A position is labelled as:
+ * - a loss in 0 plies if the opponent has K in a row,
+ * - a draw in 0 plies if the board is full,
+ * - cannot occur if the side to move has K in a row, since the game ended before,
+ * - otherwise from its replies: a win if one reply loses for the opponent, a draw if one
+ *   draws, else a loss, one ply further than the fastest win or slowest draw and loss.
+ *
+ * Writes `GAMEDB_PATH_FMT` for the size, or the path given, and prints positions per second.
+ * @code
+ * ./solveRetrograde [N K] [threads] [output]
+ * ./solveRetrograde 4 3
+ * @endcode
+ */
+
+#include <gameDb.h>
+#include <threadPool.h>
+
+#define SOLVE_TASKS_PER_THREAD 8 /**< Chunks each level is split into, per thread */
+
+/**
+ * One chunk of a level: the occupied-cell masks in `[first, last)` of the level's list,
+ * with every split of their cells into the two sides.
+ */
+struct SolveTask
+{
+    const uint64_t *occupied;
+    int first, last;
+    int n, k, stones;
+    uint8_t *entries;
+    long positions; /**< Positions labelled by this chunk */
+};
+
+static double nowSeconds()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + 1.0e-9 * ts.tv_nsec;
+}
+
+// Next mask with the same number of bits (Gosper's hack)
+static uint64_t nextCombination(uint64_t mask)
+{
+    uint64_t low = mask & -mask;
+    uint64_t ripple = mask + low;
+    return ripple | (((mask ^ ripple) >> 2) / low);
+}
+
+static uint8_t solvePosition(uint64_t me, uint64_t them, int n, int k, const uint8_t *entries)
+{
+    if (nkHasWin(me, n, k))
+    {
+        return GAMEDB_UNKNOWN;
+    }
+    if (nkHasWin(them, n, k))
+    {
+        return GAMEDB_ENTRY(GAMEDB_LOSS, 0);
+    }
+
+    uint64_t empty = ~(me | them) & ((1ULL << (n * n)) - 1);
+    if (empty == 0)
+    {
+        return GAMEDB_ENTRY(GAMEDB_DRAW, 0);
+    }
+
+    int winIn = 64, drawIn = -1, lossIn = -1;
+    while (empty)
+    {
+        uint64_t mine = me | (1ULL << nkPopLowest(&empty));
+        uint8_t reply = entries[gameDbIndex(them, mine, n)]; // the opponent moves next
+        int distance = GAMEDB_DISTANCE(reply) + 1;
+
+        switch (GAMEDB_RESULT(reply))
+        {
+        case GAMEDB_LOSS:
+            winIn = (distance < winIn) ? distance : winIn;
+            break;
+        case GAMEDB_DRAW:
+            drawIn = (distance > drawIn) ? distance : drawIn;
+            break;
+        case GAMEDB_WIN:
+            lossIn = (distance > lossIn) ? distance : lossIn;
+            break;
+        default: // cannot happen: the opponent has no line, or this position would not occur
+            break;
+        }
+    }
+
+    return (winIn < 64)   ? GAMEDB_ENTRY(GAMEDB_WIN, winIn)
+           : (drawIn >= 0) ? GAMEDB_ENTRY(GAMEDB_DRAW, drawIn)
+                           : GAMEDB_ENTRY(GAMEDB_LOSS, lossIn);
+}
+
+static void solveTask(void *arg)
+{
+    struct SolveTask *task = arg;
+    int themCount = task->stones - task->stones / 2;
+    int cells[MAX_CELLS];
+
+    for (int i = task->first; i < task->last; i++)
+    {
+        int count = 0;
+        for (uint64_t occupied = task->occupied[i]; occupied;)
+        {
+            cells[count++] = nkPopLowest(&occupied);
+        }
+
+        // every way of giving themCount of the occupied cells to the opponent
+        uint64_t limit = 1ULL << count;
+        for (uint64_t pick = (1ULL << themCount) - 1; pick < limit; pick = nextCombination(pick))
+        {
+            uint64_t me = 0, them = 0;
+            for (int c = 0; c < count; c++)
+            {
+                if (pick >> c & 1)
+                {
+                    them |= 1ULL << cells[c];
+                }
+                else
+                {
+                    me |= 1ULL << cells[c];
+                }
+            }
+
+            task->entries[gameDbIndex(me, them, task->n)] = solvePosition(me, them, task->n, task->k, task->entries);
+            task->positions++;
+            if (themCount == 0)
+            {
+                break; // the empty pick has no successor
+            }
+        }
+    }
+}
+
+static int writeDatabase(const char *path, int n, int k, const uint8_t *entries, uint32_t entryCount)
+{
+    struct GameDbHeader header = {.version = GAMEDB_VERSION, .n = (uint8_t)n, .k = (uint8_t)k, .entryCount = entryCount};
+    memcpy(header.magic, GAMEDB_MAGIC, sizeof(header.magic));
+
+    FILE *file = fopen(path, "wb");
+    if (file == NULL)
+    {
+        fprintf(stderr, "[ERROR] Cannot open %s\n", path);
+        return ERROR;
+    }
+    bool isWritten = fwrite(&header, sizeof(header), 1, file) == 1 && fwrite(entries, 1, entryCount, file) == entryCount;
+    if (fclose(file) != 0 || !isWritten)
+    {
+        fprintf(stderr, "[ERROR] Cannot write %s\n", path);
+        return ERROR;
+    }
+    return SUCCESS;
+}
+
+int main(int argc, char *argv[])
+{
+    int n = (argc > 2) ? atoi(argv[1]) : 3;
+    int k = (argc > 2) ? atoi(argv[2]) : 3;
+    int threads = (argc > 3 && atoi(argv[3]) > 0) ? atoi(argv[3]) : poolCoreCount();
+
+    if (n > GAMEDB_MAX_N || !nkIsValidSize(n, k))
+    {
+        fprintf(stderr, "[ERROR] Only boards up to %dx%d can be solved, got %dx%d K=%d\n", GAMEDB_MAX_N, GAMEDB_MAX_N, n, n, k);
+        return ERROR;
+    }
+
+    char path[64];
+    snprintf(path, sizeof(path), GAMEDB_PATH_FMT, n, n, k);
+    if (argc > 4)
+    {
+        snprintf(path, sizeof(path), "%s", argv[4]);
+    }
+
+    int cellCount = n * n;
+    uint32_t entryCount = gameDbEntryCount(n);
+    uint8_t *entries = calloc(entryCount, 1);
+    uint64_t *occupied = malloc(sizeof(uint64_t) * 12870); // C(16, 8), the largest level of a 4x4 board
+    struct SolveTask *tasks = malloc(sizeof(struct SolveTask) * threads * SOLVE_TASKS_PER_THREAD);
+    struct ThreadPool *pool = (threads > 1) ? poolCreate(threads - 1) : NULL;
+    if (entries == NULL || occupied == NULL || tasks == NULL)
+    {
+        fprintf(stderr, "[ERROR] Out of memory\n");
+        return ERROR;
+    }
+
+    printf("Solving %dx%d K=%d on %d threads\n", n, n, k, threads);
+    double start = nowSeconds();
+    long total = 0;
+
+    for (int stones = cellCount; stones >= 0; stones--)
+    {
+        double levelStart = nowSeconds();
+
+        int occupiedCount = 0;
+        uint64_t limit = 1ULL << cellCount;
+        for (uint64_t mask = (1ULL << stones) - 1; mask < limit; mask = nextCombination(mask))
+        {
+            occupied[occupiedCount++] = mask;
+            if (stones == 0)
+            {
+                break;
+            }
+        }
+
+        int taskCount = threads * SOLVE_TASKS_PER_THREAD;
+        taskCount = (taskCount > occupiedCount) ? occupiedCount : taskCount;
+        for (int t = 0; t < taskCount; t++)
+        {
+            tasks[t] = (struct SolveTask){
+                .occupied = occupied,
+                .first = (int)((long)occupiedCount * t / taskCount),
+                .last = (int)((long)occupiedCount * (t + 1) / taskCount),
+                .n = n,
+                .k = k,
+                .stones = stones,
+                .entries = entries,
+            };
+            if (pool != NULL)
+            {
+                poolSubmit(pool, solveTask, &tasks[t]);
+            }
+            else
+            {
+                solveTask(&tasks[t]);
+            }
+        }
+        if (pool != NULL)
+        {
+            poolWait(pool);
+        }
+
+        long positions = 0;
+        for (int t = 0; t < taskCount; t++)
+        {
+            positions += tasks[t].positions;
+        }
+        total += positions;
+        printf("  %2d stones: %10ld positions in %.3f s\n", stones, positions, nowSeconds() - levelStart);
+    }
+
+    double elapsed = nowSeconds() - start;
+    uint8_t root = entries[0];
+    printf("%ld positions in %.3f s (%.0f positions/sec)\n", total, elapsed, total / (elapsed > 0 ? elapsed : 1));
+    printf("Empty board: %s in %d plies\n",
+           GAMEDB_RESULT(root) == GAMEDB_WIN ? "first player wins" : GAMEDB_RESULT(root) == GAMEDB_LOSS ? "first player loses" : "draw",
+           GAMEDB_DISTANCE(root));
+
+    int status = writeDatabase(path, n, k, entries, entryCount);
+    if (status == SUCCESS)
+    {
+        printf("Wrote %s\n", path);
+    }
+
+    if (pool != NULL)
+    {
+        poolDestroy(pool);
+    }
+    free(tasks);
+    free(occupied);
+    free(entries);
+    return status;
+}
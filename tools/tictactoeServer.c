@@ -0,0 +1,461 @@
+/**
+ * @file tictactoeServer.c
+ * @author jacktan-jk
+ * @brief Hosts many games in one process over the line protocol of `serverProtocol.h`.
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2024
+ *
+ * One thread runs an epoll loop over the listening socket and every connection. It reads
+ * and parses requests, plays human moves at once and queues each `BOT` request on a
+ * thread pool with one worker per core. A worker searches the move of the connection's
+ * `Game` (`gameBotMove()`, which reaches `findBestMove()` and `getBestPosition()`), puts
+ * the connection on the finished list and wakes the loop through an eventfd. The loop
+ * then plays the move, replies and goes on with the requests pipelined behind it.
+ *
+ * Every game searches on one thread, so the cores are shared by the games instead of
+ * split within a search. A connection that hangs up during a search is freed once the
+ * search is back. SIGINT and SIGTERM stop the server.
+ * @code
+ * ./tictactoeServer [socket path | port] [ms per move]
+ * ./tictactoeServer /tmp/tictactoe.sock 50
+ * @endcode
+ */
+
+#define _GNU_SOURCE // accept4()
+
+#include <tictactoe.h>
+#include <threadPool.h>
+#include <serverProtocol.h>
+#include <stdarg.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+
+#define SERVER_MAX_EVENTS 256   /**< Events taken from one `epoll_wait()` */
+#define SERVER_BACKLOG 4096     /**< Pending connections the listening socket queues */
+#define CLIENT_BUF_SIZE 4096    /**< Bytes of requests and of replies buffered per connection */
+
+/**
+ * @struct Client
+ * @brief A connection, its game and its buffered requests and replies.
+ */
+struct Client
+{
+    int fd;
+    struct Game *game;        /**< NULL until the first `NEW` */
+    int mode;                 /**< `MODE_MM`, `MODE_ML` or `MODE_MC` */
+    uint32_t events;          /**< Events registered with epoll */
+    bool isBusy;              /**< A `BOT` request is searched on the pool */
+    bool isClosed;            /**< Hung up during a search, freed once it is back */
+    struct Position botMove;  /**< Move found by the pool */
+    struct Client *nextDone;  /**< Next connection of the finished list */
+    struct Client *nextClosed; /**< Next connection of the closed list */
+    int inLen;
+    int outLen;
+    char in[CLIENT_BUF_SIZE];
+    char out[CLIENT_BUF_SIZE];
+};
+
+static struct Engine *engine;
+static struct ThreadPool *pool;
+static int epollFd;
+static int listenFd;
+static int doneFd;                                            /**< eventfd the workers wake the loop with */
+static pthread_mutex_t doneLock = PTHREAD_MUTEX_INITIALIZER;
+static struct Client *doneList;                              /**< Searches finished, guarded by doneLock */
+static struct Client *closedList;                            /**< Closed during this epoll batch, freed after it */
+static volatile sig_atomic_t isRunning = 1;
+
+static const char *stateNames(int state)
+{
+    return (state == WIN) ? "WIN" : (state == TIE) ? "TIE" : "PLAY";
+}
+
+static void onSignal(int sig)
+{
+    (void)sig;
+    isRunning = 0;
+}
+
+static void watch(struct Client *c)
+{
+    // stop reading once the request buffer is full, so level-triggered epoll does not spin
+    uint32_t events = (c->inLen < CLIENT_BUF_SIZE ? EPOLLIN : 0) | (c->outLen > 0 ? EPOLLOUT : 0);
+    if (events != c->events)
+    {
+        struct epoll_event ev = {.events = events, .data.ptr = c};
+        epoll_ctl(epollFd, EPOLL_CTL_MOD, c->fd, &ev);
+        c->events = events;
+    }
+}
+
+static void reply(struct Client *c, const char *fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    int len = vsnprintf(c->out + c->outLen, CLIENT_BUF_SIZE - c->outLen, fmt, args);
+    va_end(args);
+    c->outLen += (len < CLIENT_BUF_SIZE - c->outLen) ? len : 0;
+}
+
+// Later events of the same epoll batch may still point to the connection
+static void freeClient(struct Client *c)
+{
+    c->nextClosed = closedList;
+    closedList = c;
+}
+
+static void freeClosedClients()
+{
+    while (closedList != NULL)
+    {
+        struct Client *c = closedList;
+        closedList = c->nextClosed;
+        gameDestroy(c->game);
+        free(c);
+    }
+}
+
+static void closeClient(struct Client *c)
+{
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, c->fd, NULL);
+    close(c->fd);
+    c->fd = ERROR;
+    if (c->isBusy)
+    {
+        c->isClosed = true; // the worker still holds it
+        gameCancel(c->game, true);
+        return;
+    }
+    freeClient(c);
+}
+
+static void searchTask(void *arg)
+{
+    struct Client *c = arg;
+    c->botMove = gameBotMove(c->game, c->mode);
+
+    pthread_mutex_lock(&doneLock);
+    c->nextDone = doneList;
+    doneList = c;
+    pthread_mutex_unlock(&doneLock);
+
+    uint64_t one = 1;
+    (void)!write(doneFd, &one, sizeof(one));
+}
+
+static int parseMode(const char *name)
+{
+    return (strcmp(name, "MM") == 0)   ? MODE_MM
+           : (strcmp(name, "ML") == 0) ? MODE_ML
+           : (strcmp(name, "MC") == 0) ? MODE_MC
+                                       : ERROR;
+}
+
+// Returns false if the connection must be closed
+static bool handleRequest(struct Client *c, char *line)
+{
+    int n, k, row, col;
+    char name[4];
+
+    if (sscanf(line, "NEW %d %d %3s", &n, &k, name) == 3)
+    {
+        int mode = parseMode(name);
+        struct Game *game = (mode != ERROR) ? gameCreate(engine, n, k) : NULL;
+        if (game == NULL || (mode == MODE_ML && (n != 3 || k != 3 || !engineHasModel(engine))))
+        {
+            gameDestroy(game);
+            reply(c, "ERR bad game\n");
+            return true;
+        }
+        gameDestroy(c->game);
+        c->game = game;
+        c->mode = mode;
+        reply(c, "OK\n");
+    }
+    else if (sscanf(line, "MOVE %d %d", &row, &col) == 2)
+    {
+        int state = (c->game != NULL) ? gamePlay(c->game, row, col) : BAD_PARAM;
+        if (state == BAD_PARAM)
+        {
+            reply(c, "ERR bad move\n");
+        }
+        else
+        {
+            reply(c, "OK %s\n", stateNames(state));
+        }
+    }
+    else if (strcmp(line, "BOT") == 0)
+    {
+        struct NKBoard b = (c->game != NULL) ? gameBoard(c->game) : (struct NKBoard){0};
+        if (c->game == NULL || gameWinner(c->game) != EMPTY || nkEmpty(&b) == 0)
+        {
+            reply(c, "ERR game over\n");
+        }
+        else
+        {
+            c->isBusy = true;
+            poolSubmit(pool, searchTask, c);
+        }
+    }
+    else if (strcmp(line, "QUIT") == 0)
+    {
+        return false;
+    }
+    else
+    {
+        reply(c, "ERR bad request\n");
+    }
+    return true;
+}
+
+// Answers the buffered requests until one is searched or the replies fill up
+static bool serveRequests(struct Client *c)
+{
+    int start = 0;
+    while (!c->isBusy && c->outLen < CLIENT_BUF_SIZE - SERVER_LINE_MAX)
+    {
+        char *end = memchr(c->in + start, '\n', c->inLen - start);
+        if (end == NULL)
+        {
+            break;
+        }
+        *end = '\0';
+        if (end > c->in + start && end[-1] == '\r')
+        {
+            end[-1] = '\0';
+        }
+
+        bool isOpen = handleRequest(c, c->in + start);
+        start = end - c->in + 1;
+        if (!isOpen)
+        {
+            return false;
+        }
+    }
+
+    memmove(c->in, c->in + start, c->inLen - start);
+    c->inLen -= start;
+    // a full buffer without a newline can never be served
+    return c->inLen < CLIENT_BUF_SIZE || c->isBusy || c->outLen >= CLIENT_BUF_SIZE - SERVER_LINE_MAX;
+}
+
+// Returns false if the connection failed
+static bool flushReplies(struct Client *c)
+{
+    int sent = 0;
+    while (sent < c->outLen)
+    {
+        ssize_t len = write(c->fd, c->out + sent, c->outLen - sent);
+        if (len < 0)
+        {
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+            {
+                break;
+            }
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return false;
+        }
+        sent += (int)len;
+    }
+    memmove(c->out, c->out + sent, c->outLen - sent);
+    c->outLen -= sent;
+    return true;
+}
+
+static void serveClient(struct Client *c, uint32_t events)
+{
+    if (c->fd == ERROR)
+    {
+        return; // closed earlier in this epoll batch
+    }
+
+    bool isOpen = true;
+    if (events & EPOLLIN)
+    {
+        ssize_t len = read(c->fd, c->in + c->inLen, CLIENT_BUF_SIZE - c->inLen);
+        if (len > 0)
+        {
+            c->inLen += (int)len;
+        }
+        else if (len == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR))
+        {
+            isOpen = false;
+        }
+    }
+    else if (events & (EPOLLHUP | EPOLLERR))
+    {
+        isOpen = false;
+    }
+
+    isOpen = isOpen && serveRequests(c) && flushReplies(c);
+    // replies written may let more pipelined requests in
+    while (isOpen && !c->isBusy && c->outLen == 0 && memchr(c->in, '\n', c->inLen) != NULL)
+    {
+        isOpen = serveRequests(c) && flushReplies(c);
+    }
+
+    if (!isOpen)
+    {
+        closeClient(c);
+        return;
+    }
+    watch(c);
+}
+
+static void acceptClients()
+{
+    for (;;)
+    {
+        int fd = accept4(listenFd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0)
+        {
+            return; // EAGAIN once the queue is empty; other errors drop this round
+        }
+
+        struct Client *c = calloc(1, sizeof(struct Client));
+        struct epoll_event ev = {.events = EPOLLIN, .data.ptr = c};
+        if (c == NULL || epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev) != 0)
+        {
+            free(c);
+            close(fd);
+            continue;
+        }
+        c->fd = fd;
+        c->events = EPOLLIN;
+    }
+}
+
+static void finishSearches()
+{
+    uint64_t count;
+    (void)!read(doneFd, &count, sizeof(count));
+
+    pthread_mutex_lock(&doneLock);
+    struct Client *list = doneList;
+    doneList = NULL;
+    pthread_mutex_unlock(&doneLock);
+
+    while (list != NULL)
+    {
+        struct Client *c = list;
+        list = c->nextDone;
+        c->isBusy = false;
+        if (c->isClosed)
+        {
+            freeClient(c);
+            continue;
+        }
+
+        struct Position move = c->botMove;
+        int state = (move.row != ERROR) ? gamePlay(c->game, move.row, move.col) : BAD_PARAM;
+        if (state == BAD_PARAM)
+        {
+            reply(c, "ERR no move\n");
+        }
+        else
+        {
+            reply(c, "MOVE %d %d %s\n", move.row, move.col, stateNames(state));
+        }
+        serveClient(c, 0);
+    }
+}
+
+static int openListener(const char *where)
+{
+    struct sockaddr_storage addr;
+    socklen_t len;
+    if (serverAddress(where, &addr, &len) != SUCCESS)
+    {
+        return ERROR;
+    }
+
+    int fd = socket(addr.ss_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+    {
+        return ERROR;
+    }
+    int on = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    if (addr.ss_family == AF_UNIX)
+    {
+        unlink(where); // left behind by a server that was killed
+    }
+
+    if (bind(fd, (struct sockaddr *)&addr, len) != 0 || listen(fd, SERVER_BACKLOG) != 0)
+    {
+        close(fd);
+        return ERROR;
+    }
+    return fd;
+}
+
+int main(int argc, char *argv[])
+{
+    const char *where = (argc > 1) ? argv[1] : SERVER_SOCKET_PATH;
+
+    struct EngineConfig config;
+    engineDefaultConfig(&config);
+    config.threads = 1; // parallel over games, not within one search
+    config.timeBudget = (argc > 2) ? atoi(argv[2]) : config.timeBudget;
+
+    signal(SIGPIPE, SIG_IGN);
+    struct sigaction sa = {.sa_handler = onSignal};
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+
+    engine = engineCreate(&config);
+    pool = poolCreate(poolCoreCount());
+    listenFd = openListener(where);
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    doneFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (engine == NULL || pool == NULL || listenFd < 0 || epollFd < 0 || doneFd < 0)
+    {
+        fprintf(stderr, "[ERROR] Could not start the server on %s\n", where);
+        return ERROR;
+    }
+
+    struct epoll_event ev = {.events = EPOLLIN, .data.ptr = &listenFd};
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &ev);
+    ev.data.ptr = &doneFd;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, doneFd, &ev);
+    fprintf(stderr, "[SERVER] Listening on %s with %d search threads\n", where, pool->threadCount);
+
+    struct epoll_event events[SERVER_MAX_EVENTS];
+    while (isRunning)
+    {
+        int count = epoll_wait(epollFd, events, SERVER_MAX_EVENTS, -1);
+        for (int i = 0; i < count; i++)
+        {
+            if (events[i].data.ptr == &listenFd)
+            {
+                acceptClients();
+            }
+            else if (events[i].data.ptr == &doneFd)
+            {
+                finishSearches();
+            }
+            else
+            {
+                serveClient(events[i].data.ptr, events[i].events);
+            }
+        }
+        freeClosedClients();
+    }
+
+    // connections and games are released with the process
+    fprintf(stderr, "[SERVER] Stopped\n");
+    if (atoi(where) <= 0)
+    {
+        unlink(where);
+    }
+    return SUCCESS;
+}
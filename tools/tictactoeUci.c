@@ -0,0 +1,471 @@
+/**
+ * @file tictactoeUci.c
+ * @author jacktan-jk
+ * @brief UCI-style engine on stdin/stdout, for scripts and batch play without GTK.
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2024
+ *
+ * Reads one command per line and answers on stdout, like a chess engine speaking UCI:
+ * @code
+ * uci                                   ->  id ..., option ..., uciok
+ * isready                               ->  readyok
+ * setoption name <Depth|Time|Mode|Threads|StatsLog|LogLevel> value <v>
+ * ucinewgame
+ * position startpos [<n> <k>] [moves <move> ...]
+ * position board <n> <k> <cells> [moves <move> ...]
+ * go [depth <ply>] [movetime <ms>] [mode <MM|ML|MC>]   ->  [info ...] bestmove <move> | bestmove (none)
+ * stop
+ * quit
+ * @endcode
+ * A move is a column letter and a row number, `a1` being the top left cell. The cells of
+ * `board` are `o`, `x` and `.` row by row from the top, rows optionally split by `/`.
+ * O (`PLAYER1`) moves first, so the side to move is O when both have as many stones.
+ * `go` searches for the side to move with `findBestMove()` and the N x N search (`MM`),
+ * `getBestPosition()` (`ML`, 3x3 only) or MCTS (`MC`), and answers `bestmove (none)`
+ * once the game is over. Depth limits the 3x3 Minimax (-1 for GODMODE); time is the
+ * budget of the larger boards and MCTS, 0 searching N x N boards to a fixed depth.
+ * A Minimax move is preceded by an `info` line with the depth completed, nodes and time;
+ * StatsLog names a file every Minimax move is appended to as a line of JSON
+ * (`searchStatsJson()`), or `<empty>` to stop. LogLevel sets the engines' `logLevel`
+ * (`error` to `trace`).
+ *
+ * Commands are read in order and each waits for the search before it, so many positions
+ * can be piped through one process. A search runs on its own thread only when no further
+ * command is waiting, so that `stop` (end a timed search with its best move so far),
+ * `isready` and `quit` are served while it runs; otherwise it runs inline and the
+ * replies are flushed once the input is drained. Debug output of the engines goes to stderr.
+ * @code
+ * printf 'position startpos\ngo\nposition board 3 3 xo./.o./... moves c3\ngo\n' | ./tictactoeUci
+ * @endcode
+ */
+
+#include <tictactoe.h>
+#include <minimax.h>
+#include <ctype.h>
+#include <unistd.h>
+
+#define UCI_INPUT_MAX 65536 /**< Bytes of input buffered, the longest command included */
+
+static struct Engine *engine;
+static struct Game *game;
+static struct EngineConfig config; /**< Settings of `setoption`, `go` may override them */
+static int mode = MODE_MM;
+static struct NKBoard board = {0, 0, 3, 3}; /**< `player` holds O's stones, `bot` X's */
+
+static FILE *out;               /**< The protocol's stdout, fd 1 being stderr for the engines */
+static pthread_t searchThread;
+static volatile bool isSearching; /**< Whether `searchThread` is running */
+static struct NKBoard searchBoard;  /**< Board of the search, side to move as `bot` */
+static int goSearchMode;
+
+static char input[UCI_INPUT_MAX];
+static size_t inputLen, inputPos;
+
+static const char *modeName(int m)
+{
+    return (m == MODE_ML) ? "ML" : (m == MODE_MC) ? "MC" : "MM";
+}
+
+static int parseMode(const char *name)
+{
+    return (strcasecmp(name, "ML") == 0) ? MODE_ML : (strcasecmp(name, "MC") == 0) ? MODE_MC
+                                                   : (strcasecmp(name, "MM") == 0) ? MODE_MM
+                                                                                   : ERROR;
+}
+
+// Returns the cell of a move like "b3", or ERROR
+static int parseMove(const char *move, int n)
+{
+    int col = tolower((unsigned char)move[0]) - 'a';
+    char *end;
+    long row = strtol(move + 1, &end, 10) - 1;
+    if (col < 0 || col >= n || row < 0 || row >= n || *end != '\0')
+    {
+        return ERROR;
+    }
+    return (int)row * n + col;
+}
+
+static bool isGameOver(const struct NKBoard *b)
+{
+    return nkHasWin(b->player, b->n, b->k) || nkHasWin(b->bot, b->n, b->k) || nkEmpty(b) == 0;
+}
+
+static void printBestMove(struct Position move)
+{
+    if (move.row == ERROR)
+    {
+        fprintf(out, "bestmove (none)\n");
+    }
+    else
+    {
+        fprintf(out, "bestmove %c%d\n", 'a' + move.col, move.row + 1);
+    }
+}
+
+static void printInfo()
+{
+    struct SearchStats stats;
+    gameSearchStats(game, &stats);
+    unsigned long long ms = stats.wallNs / 1000000;
+    // the deepest ply also counts an iteration cut short by the clock
+    int depth = (stats.depth > 0) ? stats.depth : searchStatsDepth(&stats);
+    fprintf(out, "info depth %d nodes %llu time %llu nps %llu\n", depth,
+            (unsigned long long)stats.nodes, ms, (unsigned long long)(stats.nodes * 1e9 / (stats.wallNs + 1)));
+}
+
+// Searches searchBoard and answers with the move
+static void search()
+{
+    struct Position move = gameSearch(game, searchBoard, goSearchMode);
+    if (goSearchMode == MODE_MM && move.row != ERROR)
+    {
+        printInfo();
+    }
+    printBestMove(move);
+}
+
+static void *searchMain(void *arg)
+{
+    (void)arg;
+    search();
+    fflush(out);
+    return NULL;
+}
+
+static void waitForSearch()
+{
+    if (isSearching)
+    {
+        pthread_join(searchThread, NULL);
+        isSearching = false;
+    }
+}
+
+// Returns the next command without its newline, NULL at the end of the input
+static char *readLine()
+{
+    for (;;)
+    {
+        char *start = input + inputPos;
+        char *end = memchr(start, '\n', inputLen - inputPos);
+        if (end != NULL)
+        {
+            *end = '\0';
+            inputPos = end - input + 1;
+            if (end > start && end[-1] == '\r')
+            {
+                end[-1] = '\0';
+            }
+            return start;
+        }
+        memmove(input, start, inputLen - inputPos);
+        inputLen -= inputPos;
+        inputPos = 0;
+        if (inputLen == sizeof(input) - 1)
+        {
+            inputLen = 0; // a line this long is no command, drop it
+        }
+
+        fflush(out); // replies of the inline searches, before waiting for more input
+        ssize_t len = read(STDIN_FILENO, input + inputLen, sizeof(input) - 1 - inputLen);
+        if (len <= 0)
+        {
+            if (inputLen == 0)
+            {
+                return NULL;
+            }
+            input[inputLen++] = '\n'; // last command without a newline
+            continue;
+        }
+        inputLen += len;
+    }
+}
+
+// Whether a further complete command is waiting and is not one a running search must serve
+static bool hasQueuedCommand()
+{
+    char *next = memchr(input + inputPos, '\n', inputLen - inputPos);
+    if (next == NULL)
+    {
+        return false;
+    }
+    const char *start = input + inputPos;
+    while (isspace((unsigned char)*start) && start < next)
+    {
+        start++;
+    }
+    return strncmp(start, "stop", 4) != 0 && strncmp(start, "quit", 4) != 0 && strncmp(start, "isready", 7) != 0;
+}
+
+static void commandUci()
+{
+    fprintf(out, "id name tictactoe\n");
+    fprintf(out, "id author jacktan-jk\n");
+    fprintf(out, "option name Depth type spin default %d min -1 max %d\n", config.depthLimit, BB_CELLS);
+    fprintf(out, "option name Time type spin default %d min 0 max 600000\n", config.timeBudget);
+    fprintf(out, "option name Mode type combo default %s var MM var ML var MC\n", modeName(mode));
+    fprintf(out, "option name Threads type spin default %d min 0 max 256\n", config.threads);
+    fprintf(out, "option name StatsLog type string default <empty>\n");
+    const char *levels[] = {"error", "warn", "info", "debug", "trace"};
+    fprintf(out, "option name LogLevel type combo default %s var error var warn var info var debug var trace\n",
+            levels[logLevel]);
+    fprintf(out, "uciok\n");
+}
+
+static void commandSetOption(char *args)
+{
+    char *name = strstr(args, "name ");
+    char *value = strstr(args, " value ");
+    if (name == NULL || value == NULL)
+    {
+        fprintf(out, "info string setoption needs a name and a value\n");
+        return;
+    }
+    *value = '\0';
+    name += strlen("name ");
+    value += strlen(" value ");
+
+    if (strcasecmp(name, "Depth") == 0)
+    {
+        config.depthLimit = (atoi(value) < 0) ? NO_DEPTH_LIMIT : atoi(value);
+    }
+    else if (strcasecmp(name, "Time") == 0 && atoi(value) >= 0)
+    {
+        config.timeBudget = atoi(value);
+    }
+    else if (strcasecmp(name, "Threads") == 0 && atoi(value) >= 0)
+    {
+        config.threads = atoi(value);
+    }
+    else if (strcasecmp(name, "Mode") == 0 && parseMode(value) != ERROR)
+    {
+        mode = parseMode(value);
+    }
+    else if (strcasecmp(name, "LogLevel") == 0 && logParseLevel(value) != ERROR)
+    {
+        logSetLevel(logParseLevel(value));
+    }
+    else if (strcasecmp(name, "StatsLog") == 0)
+    {
+        if (searchStatsLog != NULL)
+        {
+            fclose(searchStatsLog);
+            searchStatsLog = NULL;
+        }
+        if (strcmp(value, "<empty>") != 0 && (searchStatsLog = fopen(value, "a")) == NULL)
+        {
+            fprintf(out, "info string cannot open %s\n", value);
+        }
+    }
+    else
+    {
+        fprintf(out, "info string unknown option or value: %s = %s\n", name, value);
+    }
+}
+
+static void commandPosition(char *args)
+{
+    struct NKBoard b = {0, 0, 3, 3};
+    char *save;
+    char *token = strtok_r(args, " \t", &save);
+    bool isBoard = token != NULL && strcmp(token, "board") == 0;
+    if (token == NULL || (!isBoard && strcmp(token, "startpos") != 0))
+    {
+        fprintf(out, "info string position needs startpos or board\n");
+        return;
+    }
+
+    token = strtok_r(NULL, " \t", &save);
+    if (token != NULL && isdigit((unsigned char)token[0]))
+    {
+        b.n = atoi(token);
+        token = strtok_r(NULL, " \t", &save);
+        b.k = (token != NULL) ? atoi(token) : 0;
+        token = strtok_r(NULL, " \t", &save);
+    }
+    if (!nkIsValidSize(b.n, b.k))
+    {
+        fprintf(out, "info string unsupported board size\n");
+        return;
+    }
+
+    if (isBoard)
+    {
+        int cell = 0;
+        for (const char *c = (token != NULL) ? token : ""; *c != '\0'; c++)
+        {
+            if (*c == '/')
+            {
+                continue;
+            }
+            if (cell == b.n * b.n || strchr("oOxX.", *c) == NULL)
+            {
+                cell = ERROR;
+                break;
+            }
+            b.player |= (uint64_t)(tolower((unsigned char)*c) == 'o') << cell;
+            b.bot |= (uint64_t)(tolower((unsigned char)*c) == 'x') << cell;
+            cell++;
+        }
+        int stones = __builtin_popcountll(b.player) - __builtin_popcountll(b.bot);
+        if (cell != b.n * b.n || stones < 0 || stones > 1)
+        {
+            fprintf(out, "info string board needs %d cells of o, x or . with O moving first\n", b.n * b.n);
+            return;
+        }
+        token = strtok_r(NULL, " \t", &save);
+    }
+
+    if (token != NULL && strcmp(token, "moves") == 0)
+    {
+        while ((token = strtok_r(NULL, " \t", &save)) != NULL)
+        {
+            int cell = parseMove(token, b.n);
+            if (cell == ERROR || (nkEmpty(&b) >> cell & 1) == 0 || isGameOver(&b))
+            {
+                fprintf(out, "info string illegal move %s\n", token);
+                return;
+            }
+            bool isOToMove = __builtin_popcountll(b.player) == __builtin_popcountll(b.bot);
+            *(isOToMove ? &b.player : &b.bot) |= 1ULL << cell;
+        }
+    }
+    board = b;
+}
+
+static void commandGo(char *args)
+{
+    struct EngineConfig goConfig = config;
+    int goMode = mode;
+    char *save;
+    for (char *token = strtok_r(args, " \t", &save); token != NULL; token = strtok_r(NULL, " \t", &save))
+    {
+        char *value = strtok_r(NULL, " \t", &save);
+        if (value == NULL)
+        {
+            break;
+        }
+        if (strcmp(token, "depth") == 0)
+        {
+            goConfig.depthLimit = (atoi(value) < 0) ? NO_DEPTH_LIMIT : atoi(value);
+        }
+        else if (strcmp(token, "movetime") == 0)
+        {
+            goConfig.timeBudget = atoi(value);
+        }
+        else if (strcmp(token, "mode") == 0 && parseMode(value) != ERROR)
+        {
+            goMode = parseMode(value);
+        }
+    }
+
+    if (isGameOver(&board))
+    {
+        printBestMove((struct Position){ERROR, ERROR});
+        return;
+    }
+
+    // the engines play the BOT's stones
+    searchBoard = board;
+    if (__builtin_popcountll(board.player) == __builtin_popcountll(board.bot))
+    {
+        searchBoard.bot = board.player;
+        searchBoard.player = board.bot;
+    }
+    goSearchMode = goMode;
+    gameConfigure(game, &goConfig);
+    gameStop(game, false);
+
+    if (hasQueuedCommand() || pthread_create(&searchThread, NULL, searchMain, NULL) != 0)
+    {
+        // the next command would wait for this search anyway
+        search();
+        return;
+    }
+    isSearching = true;
+}
+
+int main()
+{
+    // the protocol keeps stdout, the engines' debug prints go to stderr
+    out = fdopen(dup(STDOUT_FILENO), "w");
+    dup2(STDERR_FILENO, STDOUT_FILENO);
+    if (out == NULL)
+    {
+        return ERROR;
+    }
+
+    engineDefaultConfig(&config);
+    engine = engineCreate(&config);
+    game = (engine != NULL) ? gameCreate(engine, 3, 3) : NULL;
+    if (game == NULL)
+    {
+        return ERROR;
+    }
+
+    char *line;
+    while ((line = readLine()) != NULL)
+    {
+        while (isspace((unsigned char)*line))
+        {
+            line++;
+        }
+        char *args = line + strcspn(line, " \t");
+        if (*args != '\0')
+        {
+            *args++ = '\0';
+        }
+
+        if (strcmp(line, "stop") == 0)
+        {
+            gameStop(game, true);
+            continue;
+        }
+        if (strcmp(line, "isready") == 0)
+        {
+            fprintf(out, "readyok\n");
+            fflush(out);
+            continue;
+        }
+        if (strcmp(line, "quit") == 0)
+        {
+            gameCancel(game, true);
+            break;
+        }
+
+        waitForSearch();
+        if (strcmp(line, "uci") == 0)
+        {
+            commandUci();
+        }
+        else if (strcmp(line, "setoption") == 0)
+        {
+            commandSetOption(args);
+        }
+        else if (strcmp(line, "ucinewgame") == 0)
+        {
+            board = (struct NKBoard){0, 0, 3, 3};
+        }
+        else if (strcmp(line, "position") == 0)
+        {
+            commandPosition(args);
+        }
+        else if (strcmp(line, "go") == 0)
+        {
+            commandGo(args);
+        }
+        else if (*line != '\0')
+        {
+            fprintf(out, "info string unknown command %s\n", line);
+        }
+    }
+
+    waitForSearch();
+    fflush(out);
+    gameDestroy(game);
+    engineDestroy(engine);
+    return SUCCESS;
+}
@@ -0,0 +1,300 @@
+/**
+ * @file tournament.c
+ * @author jacktan-jk
+ * @brief Plays the 3x3 engines against each other on every core and rates them.
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2024
+ *
+ * The players are Minimax with GODMODE (`NO_DEPTH_LIMIT`), Minimax without it
+ * (`MINIMAX_DEPTH_LIMIT`), the naive Bayes bot (`getBestPosition()`) and a uniformly random
+ * mover. Every ordered pair plays the same number of games, each side once as `PLAYER1`
+ * (O, moving first), spread over one thread per core. Each player searches in its own
+ * libtictactoe `Game`, so the Minimax moves come from the generated move table and no move
+ * reads or writes the best move file. The naive Bayes bot falls back to a random move
+ * when it has none, which is counted.
+ *
+ * Prints, for every player against every other, its wins, draws and losses over both
+ * colours and its score, then Elo ratings fitted to all results (Bradley-Terry, a draw
+ * being half a win, random mover anchored at 0) and the games per second. The engines'
+ * per-move log records are turned off while the games run (`logSetLevel()`).
+ * @code
+ * ./tournament [games] [threads]
+ * ./tournament 1000000
+ * @endcode
+ */
+
+#include <tictactoe.h>
+#include <minimax.h>
+#include <math.h>
+
+#define PLAYER_GODMODE 0
+#define PLAYER_MINIMAX 1
+#define PLAYER_BAYES 2
+#define PLAYER_RANDOM 3
+#define PLAYERS 4
+
+#define ELO_ITERATIONS 1000 /**< Bradley-Terry fitting rounds */
+
+static const char *playerNames[PLAYERS] = {"Minimax GODMODE", "Minimax depth 2", "Naive Bayes", "Random"};
+
+/**
+ * @struct Results
+ * @brief Games of one thread, merged at the end.
+ */
+struct Results
+{
+    long wins[PLAYERS][PLAYERS];   /**< [first][second]: games won by the first mover */
+    long draws[PLAYERS][PLAYERS];
+    long losses[PLAYERS][PLAYERS];
+    long fallbacks;                /**< Random moves played for a naive Bayes bot without a move */
+};
+
+/**
+ * @struct Worker
+ * @brief Games and results of one thread.
+ */
+struct Worker
+{
+    pthread_t thread;
+    long gamesPerPair;
+    uint64_t rng;
+    struct Results results;
+};
+
+static struct Engine *engines[PLAYERS];
+
+static int randomCell(uint64_t empty, uint64_t *rng)
+{
+    *rng ^= *rng << 13;
+    *rng ^= *rng >> 7;
+    *rng ^= *rng << 17;
+    for (int skip = (int)((*rng >> 32) % (uint64_t)__builtin_popcountll(empty)); skip > 0; skip--)
+    {
+        nkPopLowest(&empty);
+    }
+    return nkPopLowest(&empty);
+}
+
+// Plays one game; returns PLAYER1 or BOT for the winner, EMPTY for a draw
+static int playGame(struct Game *games[2], const int players[2], struct Worker *w)
+{
+    gameReset(games[0]);
+    gameReset(games[1]);
+
+    for (int state = PLAY, side = 0;; side = !side)
+    {
+        int player = players[side];
+        struct NKBoard b = gameBoard(games[side]);
+        struct Position move = {ERROR, ERROR};
+        if (player != PLAYER_RANDOM)
+        {
+            move = gameBotMove(games[side], player == PLAYER_BAYES ? MODE_ML : MODE_MM);
+        }
+        if (move.row == ERROR)
+        {
+            w->results.fallbacks += player == PLAYER_BAYES;
+            int cell = randomCell(nkEmpty(&b), &w->rng);
+            move = (struct Position){cell / b.n, cell % b.n};
+        }
+
+        state = gamePlay(games[0], move.row, move.col);
+        gamePlay(games[1], move.row, move.col);
+        if (state != PLAY)
+        {
+            return (state == WIN) ? gameWinner(games[0]) : EMPTY;
+        }
+    }
+}
+
+static void *runGames(void *arg)
+{
+    struct Worker *w = arg;
+    struct Game *games[PLAYERS];
+    for (int p = 0; p < PLAYERS; p++)
+    {
+        games[p] = gameCreate(engines[p], 3, 3);
+    }
+
+    for (int first = 0; first < PLAYERS; first++)
+    {
+        for (int second = 0; second < PLAYERS; second++)
+        {
+            if (first == second)
+            {
+                continue;
+            }
+            // each player moves on its own game, so a pair needs two
+            struct Game *pair[2] = {games[first], gameCreate(engines[second], 3, 3)};
+            int players[2] = {first, second};
+            for (long g = 0; g < w->gamesPerPair && pair[1] != NULL; g++)
+            {
+                int winner = playGame(pair, players, w);
+                w->results.wins[first][second] += winner == PLAYER1;
+                w->results.draws[first][second] += winner == EMPTY;
+                w->results.losses[first][second] += winner == BOT;
+            }
+            gameDestroy(pair[1]);
+        }
+    }
+
+    for (int p = 0; p < PLAYERS; p++)
+    {
+        gameDestroy(games[p]);
+    }
+    return NULL;
+}
+
+// Bradley-Terry strengths by minorisation-maximisation, as Elo relative to the random mover
+static void fitElo(const double score[PLAYERS][PLAYERS], const double played[PLAYERS][PLAYERS], double elo[PLAYERS])
+{
+    double gamma[PLAYERS];
+    for (int p = 0; p < PLAYERS; p++)
+    {
+        gamma[p] = 1;
+    }
+
+    for (int it = 0; it < ELO_ITERATIONS; it++)
+    {
+        for (int p = 0; p < PLAYERS; p++)
+        {
+            double won = 0, expected = 0;
+            for (int q = 0; q < PLAYERS; q++)
+            {
+                if (q != p && played[p][q] > 0)
+                {
+                    won += score[p][q];
+                    expected += played[p][q] / (gamma[p] + gamma[q]);
+                }
+            }
+            gamma[p] = (won > 0 && expected > 0) ? won / expected : 1e-9;
+        }
+    }
+
+    for (int p = 0; p < PLAYERS; p++)
+    {
+        elo[p] = 400 * log10(gamma[p] / gamma[PLAYER_RANDOM]);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    long totalGames = (argc > 1) ? atol(argv[1]) : 1000000;
+    int threads = (argc > 2) ? atoi(argv[2]) : poolCoreCount();
+    int pairs = PLAYERS * (PLAYERS - 1);
+    if (totalGames < pairs || threads <= 0)
+    {
+        fprintf(stderr, "[ERROR] Usage: %s [games, at least %d] [threads]\n", argv[0], pairs);
+        return BAD_PARAM;
+    }
+
+    struct EngineConfig config;
+    engineDefaultConfig(&config);
+    config.threads = 1; // one game per core instead
+    config.useModel = false;
+    for (int p = 0; p < PLAYERS; p++)
+    {
+        struct EngineConfig c = config;
+        c.depthLimit = (p == PLAYER_GODMODE) ? NO_DEPTH_LIMIT : MINIMAX_DEPTH_LIMIT;
+        c.useModel = p == PLAYER_BAYES;
+        engines[p] = engineCreate(&c);
+        if (engines[p] == NULL)
+        {
+            return ERROR;
+        }
+    }
+    if (!engineHasModel(engines[PLAYER_BAYES]))
+    {
+        fprintf(stderr, "[ERROR] The naive Bayes model could not be trained\n");
+        return ERROR;
+    }
+
+    struct Worker *workers = calloc(threads, sizeof(struct Worker));
+    long gamesPerPair = totalGames / pairs / threads;
+    gamesPerPair = (gamesPerPair > 0) ? gamesPerPair : 1;
+
+    // the engines log every move at LOG_LEVEL_DEBUG
+    int savedLevel = logLevel;
+    logSetLevel(LOG_LEVEL_WARN);
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int t = 0; t < threads; t++)
+    {
+        workers[t].gamesPerPair = gamesPerPair;
+        workers[t].rng = 0x9E3779B97F4A7C15ULL * (t + 1) ^ (uint64_t)start.tv_nsec;
+        if (pthread_create(&workers[t].thread, NULL, runGames, &workers[t]) != 0)
+        {
+            runGames(&workers[t]);
+            workers[t].thread = 0;
+        }
+    }
+    for (int t = 0; t < threads; t++)
+    {
+        if (workers[t].thread != 0)
+        {
+            pthread_join(workers[t].thread, NULL);
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    logSetLevel(savedLevel);
+
+    struct Results total = {0};
+    for (int t = 0; t < threads; t++)
+    {
+        for (int p = 0; p < PLAYERS; p++)
+        {
+            for (int q = 0; q < PLAYERS; q++)
+            {
+                total.wins[p][q] += workers[t].results.wins[p][q];
+                total.draws[p][q] += workers[t].results.draws[p][q];
+                total.losses[p][q] += workers[t].results.losses[p][q];
+            }
+        }
+        total.fallbacks += workers[t].results.fallbacks;
+    }
+
+    // both colours from the row player's side
+    double score[PLAYERS][PLAYERS] = {{0}}, played[PLAYERS][PLAYERS] = {{0}};
+    long games = 0;
+    printf("%-16s %-16s %10s %10s %10s %7s\n", "player", "opponent", "wins", "draws", "losses", "score");
+    for (int p = 0; p < PLAYERS; p++)
+    {
+        for (int q = 0; q < PLAYERS; q++)
+        {
+            if (p == q)
+            {
+                continue;
+            }
+            long won = total.wins[p][q] + total.losses[q][p];
+            long drawn = total.draws[p][q] + total.draws[q][p];
+            long lost = total.losses[p][q] + total.wins[q][p];
+            played[p][q] = won + drawn + lost;
+            score[p][q] = won + 0.5 * drawn;
+            games += total.wins[p][q] + total.draws[p][q] + total.losses[p][q];
+            printf("%-16s %-16s %10ld %10ld %10ld %6.1f%%\n", playerNames[p], playerNames[q], won, drawn, lost,
+                   100 * score[p][q] / played[p][q]);
+        }
+    }
+
+    double elo[PLAYERS];
+    fitElo(score, played, elo);
+    printf("\nElo (random mover = 0):\n");
+    for (int p = 0; p < PLAYERS; p++)
+    {
+        printf("%-16s %+8.0f\n", playerNames[p], elo[p]);
+    }
+
+    double seconds = (end.tv_sec - start.tv_sec) + 1.0e-9 * (end.tv_nsec - start.tv_nsec);
+    printf("\n%ld games on %d threads in %.2f s: %.0f games/sec (%.1f million/min), %ld naive Bayes fallbacks\n",
+           games, threads, seconds, games / seconds, games / seconds * 60 / 1e6, total.fallbacks);
+
+    for (int p = 0; p < PLAYERS; p++)
+    {
+        engineDestroy(engines[p]);
+    }
+    free(workers);
+    return SUCCESS;
+}